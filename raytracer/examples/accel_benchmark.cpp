@@ -0,0 +1,284 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "../include/core/Vector3.h"
+#include "../include/core/Camera.h"
+#include "../include/core/Random.h"
+#include "../include/geometry/Sphere.h"
+#include "../include/geometry/Box.h"
+#include "../include/geometry/Scene.h"
+#include "../include/geometry/TriangleMesh.h"
+#include "../include/geometry/Instance.h"
+#include "../include/light/PointLight.h"
+
+// Comparação das estruturas de aceleração da cena (BVH, grade uniforme,
+// grade em dois níveis e árvore kd) num conjunto de cenas, das Cornell
+// densas de objetos pequenos a mundos grandes e esparsos. Para cada par
+// cena/estrutura são medidos o tempo de construção, a memória da estrutura
+// e a vazão de raios primários (um por pixel) e de sombra (um por
+// interseção primária, até a luz), em milhões de raios por segundo. A
+// BVH é a referência: as demais estruturas devem produzir, pixel a pixel,
+// os mesmos acertos e sombras, e as divergências são listadas na tabela.
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Completa o texto com espaços até "width" colunas. std::setw conta bytes,
+// o que desalinha os textos com acentos em UTF-8; aqui cada caractere
+// ocupa uma coluna (os bytes de continuação 10xxxxxx não são contados)
+static std::string padded(const std::string& text, int width, bool alignLeft) {
+    int columns = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) columns++;
+    }
+    std::string padding(columns < width ? width - columns : 0, ' ');
+    return alignLeft ? text + padding : padding + text;
+}
+
+// Cena de teste: objetos, câmera e a luz usada pelos raios de sombra
+struct BenchmarkScene {
+    std::string name;
+    Scene scene;
+    Camera camera;
+    Light* light;
+
+    BenchmarkScene(const std::string& name, const Camera& camera) : name(name), camera(camera), light(nullptr) {}
+};
+
+// Estrutura avaliada: tipo e parâmetros da grade
+struct BenchmarkAccelerator {
+    std::string name;
+    AcceleratorType type;
+    int maxCellItems;   // Só para a grade (0: uniforme)
+};
+
+static Material* makeMaterial(const Color& color) {
+    return new Material(color * 0.1f, color, Color(0.2f, 0.2f, 0.2f), 16.0f);
+}
+
+// Caixa de Cornell com uma pilha densa de esferas e caixas pequenas
+static BenchmarkScene* cornellScene() {
+    BenchmarkScene* bench = new BenchmarkScene("Cornell densa",
+        Camera(Vector3(2.775f, 3.2f, 12.775f), Vector3(2.775f, 2.775f, 2.775f), Vector3(0, 1, 0), 50.0f, 4.0f / 3.0f, 1.0f));
+    Scene& scene = bench->scene;
+    Material* white = makeMaterial(Color(0.7f, 0.7f, 0.7f));
+    Material* red = makeMaterial(Color(0.7f, 0.1f, 0.1f));
+    Material* green = makeMaterial(Color(0.1f, 0.7f, 0.1f));
+    scene.addObject(new Box(Vector3(-0.1f, -0.1f, -0.1f), Vector3(5.65f, 5.65f, 0.0f), white));
+    scene.addObject(new Box(Vector3(-0.1f, -0.1f, 0.0f), Vector3(0.0f, 5.55f, 5.55f), green));
+    scene.addObject(new Box(Vector3(5.55f, -0.1f, 0.0f), Vector3(5.65f, 5.55f, 5.55f), red));
+    scene.addObject(new Box(Vector3(0.0f, 5.55f, 0.0f), Vector3(5.55f, 5.65f, 5.55f), white));
+    scene.addObject(new Box(Vector3(-0.1f, -0.1f, 0.0f), Vector3(5.65f, 0.0f, 5.55f), white));
+
+    // Grade de 20 x 12 x 20 objetos no fundo da caixa
+    for (int x = 0; x < 20; x++) {
+        for (int y = 0; y < 12; y++) {
+            for (int z = 0; z < 20; z++) {
+                Vector3 center(0.3f + x * 0.25f, 0.12f + y * 0.25f, 0.3f + z * 0.25f);
+                Material* material = (x + y + z) % 3 == 0 ? red : ((x + y + z) % 3 == 1 ? green : white);
+                if ((x + z) % 2 == 0) scene.addObject(new Sphere(center, 0.1f, material));
+                else scene.addObject(new Box(center - Vector3(0.08f, 0.08f, 0.08f), center + Vector3(0.08f, 0.08f, 0.08f), material));
+            }
+        }
+    }
+    bench->light = new PointLight(Vector3(2.775f, 5.4f, 2.775f), Color(1.0f, 1.0f, 1.0f));
+    scene.addLight(bench->light);
+    return bench;
+}
+
+// Nuvem uniforme de esferas pequenas
+static BenchmarkScene* uniformScene() {
+    BenchmarkScene* bench = new BenchmarkScene("Esferas uniformes",
+        Camera(Vector3(0, 0, 90), Vector3(0, 0, 0), Vector3(0, 1, 0), 60.0f, 4.0f / 3.0f, 1.0f));
+    Material* material = makeMaterial(Color(0.6f, 0.6f, 0.8f));
+    RNG rng(1, 0, 0);
+    for (int i = 0; i < 50000; i++) {
+        Vector3 center(rng.nextFloat() * 60 - 30, rng.nextFloat() * 60 - 30, rng.nextFloat() * 60 - 30);
+        bench->scene.addObject(new Sphere(center, 0.2f + rng.nextFloat() * 0.3f, material));
+    }
+    bench->light = new PointLight(Vector3(50, 80, 60), Color(1.0f, 1.0f, 1.0f));
+    bench->scene.addLight(bench->light);
+    return bench;
+}
+
+// Mundo grande e esparso: chão enorme, aglomerados densos distantes entre
+// si e construções espalhadas ("bule no estádio")
+static BenchmarkScene* sparseScene() {
+    BenchmarkScene* bench = new BenchmarkScene("Mundo esparso",
+        Camera(Vector3(0, 60, 400), Vector3(0, 0, 0), Vector3(0, 1, 0), 60.0f, 4.0f / 3.0f, 1.0f));
+    Scene& scene = bench->scene;
+    Material* ground = makeMaterial(Color(0.5f, 0.5f, 0.4f));
+    Material* material = makeMaterial(Color(0.8f, 0.4f, 0.2f));
+    scene.addObject(new Box(Vector3(-1000, -1, -1000), Vector3(1000, 0, 1000), ground));
+    RNG rng(2, 0, 0);
+    for (int cluster = 0; cluster < 8; cluster++) {
+        Vector3 center(rng.nextFloat() * 600 - 300, 6, rng.nextFloat() * 600 - 300);
+        for (int i = 0; i < 5000; i++) {
+            Vector3 offset(rng.nextFloat() * 10 - 5, rng.nextFloat() * 10 - 5, rng.nextFloat() * 10 - 5);
+            scene.addObject(new Sphere(center + offset, 0.08f, material));
+        }
+    }
+    for (int i = 0; i < 300; i++) {
+        Vector3 base(rng.nextFloat() * 1600 - 800, 0, rng.nextFloat() * 1600 - 800);
+        float size = 2 + rng.nextFloat() * 8;
+        scene.addObject(new Box(base - Vector3(size, 0, size), base + Vector3(size, size * 3, size), ground));
+    }
+    bench->light = new PointLight(Vector3(100, 300, 200), Color(1.0f, 1.0f, 1.0f));
+    scene.addLight(bench->light);
+    return bench;
+}
+
+// Instâncias de uma malha (esfera de 8192 triângulos) com escalas variadas:
+// objetos caros de testar, espalhados num plano
+static BenchmarkScene* instanceScene() {
+    BenchmarkScene* bench = new BenchmarkScene("Instâncias de malha",
+        Camera(Vector3(0, 40, 120), Vector3(0, 0, 0), Vector3(0, 1, 0), 60.0f, 4.0f / 3.0f, 1.0f));
+    std::shared_ptr<MeshData> mesh = std::make_shared<MeshData>();
+    const int rings = 64, segments = 64;
+    for (int i = 0; i <= rings; i++) {
+        for (int j = 0; j <= segments; j++) {
+            float theta = static_cast<float>(M_PI) * i / rings;
+            float phi = 2.0f * static_cast<float>(M_PI) * j / segments;
+            mesh->positions.push_back(Vector3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (int i = 0; i < rings; i++) {
+        for (int j = 0; j < segments; j++) {
+            unsigned int a = i * (segments + 1) + j, b = a + 1, c = a + segments + 1, d = c + 1;
+            unsigned int triangles[6] = {a, c, b, b, c, d};
+            mesh->indices.insert(mesh->indices.end(), triangles, triangles + 6);
+        }
+    }
+    std::shared_ptr<BLAS> blas = std::make_shared<BLAS>();
+    blas->add(new TriangleMesh(mesh, makeMaterial(Color(0.3f, 0.6f, 0.3f))));
+    blas->build();
+
+    RNG rng(3, 0, 0);
+    for (int i = 0; i < 4000; i++) {
+        Vector3 position(rng.nextFloat() * 200 - 100, 0, rng.nextFloat() * 200 - 100);
+        float scale = 0.3f + rng.nextFloat() * 1.5f;
+        bench->scene.addObject(new Instance(blas, AffineMatrix::translate(position + Vector3(0, scale, 0)) *
+                                                  AffineMatrix::scale(Vector3(scale, scale, scale))));
+    }
+    bench->light = new PointLight(Vector3(30, 100, 60), Color(1.0f, 1.0f, 1.0f));
+    bench->scene.addLight(bench->light);
+    return bench;
+}
+
+int main() {
+    const int width = 640;
+    const int height = 480;
+
+    std::vector<BenchmarkScene*> scenes;
+    scenes.push_back(cornellScene());
+    scenes.push_back(uniformScene());
+    scenes.push_back(sparseScene());
+    scenes.push_back(instanceScene());
+
+    std::vector<BenchmarkAccelerator> accelerators;
+    accelerators.push_back(BenchmarkAccelerator{"BVH", AcceleratorType::BVH, 0});
+    accelerators.push_back(BenchmarkAccelerator{"Grade uniforme", AcceleratorType::Grid, 0});
+    accelerators.push_back(BenchmarkAccelerator{"Grade 2 níveis", AcceleratorType::Grid, 16});
+    accelerators.push_back(BenchmarkAccelerator{"Árvore kd", AcceleratorType::KdTree, 0});
+
+    std::vector<Ray> primary(width * height);
+    std::vector<HitRecord> records(width * height);
+    std::vector<char> found(width * height);
+    std::vector<char> inShadow(width * height);
+
+    for (size_t s = 0; s < scenes.size(); s++) {
+        BenchmarkScene& bench = *scenes[s];
+        Scene& scene = bench.scene;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                primary[y * width + x] = bench.camera.getRay((x + 0.5f) / width, (y + 0.5f) / height);
+            }
+        }
+
+        std::cout << "\n" << bench.name << " (" << scene.objects.size() << " objetos, "
+                  << primary.size() << " raios primários)" << std::endl;
+        std::cout << padded("Estrutura", 18, true)
+                  << padded("Construção (ms)", 16, false) << padded("Memória (KB)", 14, false)
+                  << padded("Primários (Mr/s)", 18, false) << padded("Sombra (Mr/s)", 16, false)
+                  << padded("Acertos", 10, false) << padded("Sombras", 10, false)
+                  << padded("Divergências", 14, false) << std::endl;
+
+        // Resultados da BVH (primeira estrutura), referência das demais
+        std::vector<char> referenceFound(primary.size());
+        std::vector<float> referenceT(primary.size());
+        std::vector<char> referenceShadowed(primary.size());
+
+        for (size_t a = 0; a < accelerators.size(); a++) {
+            const BenchmarkAccelerator& accelerator = accelerators[a];
+            scene.accelerator = accelerator.type;
+            scene.grid.maxCellItems = accelerator.maxCellItems;
+
+            Clock::time_point start = Clock::now();
+            scene.build();
+            double buildTime = secondsSince(start);
+
+            // Raios primários: interseção mais próxima
+            int hits = 0;
+            start = Clock::now();
+            #pragma omp parallel for schedule(dynamic, 256) reduction(+:hits)
+            for (int i = 0; i < static_cast<int>(primary.size()); i++) {
+                found[i] = scene.hit(primary[i], 0.001f, std::numeric_limits<float>::infinity(), records[i]);
+                hits += found[i];
+            }
+            double primaryTime = secondsSince(start);
+
+            // Raios de sombra: oclusão entre cada interseção e a luz
+            int shadowed = 0;
+            start = Clock::now();
+            #pragma omp parallel for schedule(dynamic, 256) reduction(+:shadowed)
+            for (int i = 0; i < static_cast<int>(primary.size()); i++) {
+                inShadow[i] = 0;
+                if (!found[i]) continue;
+                LightSample sample = bench.light->sample(records[i].point, 0.5f, 0.5f);
+                inShadow[i] = scene.isShadowed(records[i].point, sample);
+                shadowed += inShadow[i];
+            }
+            double shadowTime = secondsSince(start);
+
+            // Pixels cujo acerto primário (ou a distância dele) ou a sombra
+            // diferem da BVH
+            int hitMismatches = 0;
+            int shadowMismatches = 0;
+            for (size_t i = 0; i < primary.size(); i++) {
+                if (a == 0) {
+                    referenceFound[i] = found[i];
+                    referenceT[i] = found[i] ? records[i].t : 0.0f;
+                    referenceShadowed[i] = inShadow[i];
+                    continue;
+                }
+                if (found[i] != referenceFound[i] || (found[i] && records[i].t != referenceT[i])) hitMismatches++;
+                if (inShadow[i] != referenceShadowed[i]) shadowMismatches++;
+            }
+
+            std::cout << padded(accelerator.name, 18, true) << std::fixed
+                      << std::setprecision(1) << std::setw(16) << buildTime * 1000.0
+                      << std::setw(14) << scene.acceleratorMemory() / 1024.0
+                      << std::setprecision(2) << std::setw(18) << primary.size() / primaryTime * 1e-6
+                      << std::setw(16) << hits / shadowTime * 1e-6
+                      << std::setw(10) << hits << std::setw(10) << shadowed;
+            if (a == 0) {
+                std::cout << padded("(ref.)", 14, false) << std::endl;
+            } else {
+                std::cout << std::setw(14) << hitMismatches + shadowMismatches << std::endl;
+                if (hitMismatches + shadowMismatches > 0) {
+                    std::cout << "  ! " << accelerator.name << " difere da BVH em " << hitMismatches
+                              << " acertos e " << shadowMismatches << " sombras" << std::endl;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
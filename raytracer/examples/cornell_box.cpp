@@ -7,8 +7,7 @@
 #include "../include/geometry/Sphere.h"
 #include "../include/geometry/Box.h"
 #include "../include/geometry/Scene.h"
-#include "../include/transform/Translate.h"
-#include "../include/transform/Rotate.h"
+#include "../include/geometry/OrientedBox.h"
 #include "../include/light/PointLight.h"
 #include "../include/light/AmbientLight.h"
 
@@ -85,16 +84,16 @@ int main() {
     
     // Blocos dentro da cena
     // Bloco pequeno (com rotação)
-    Box* smallBox = new Box(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 1.65f, 0.30f), grayMaterial.get());
-    Rotate* rotatedSmallBox = new Rotate(smallBox, -18.0f, 0.0f, 1.0f, 0.0f);
-    Translate* smallBoxPos = new Translate(rotatedSmallBox, 3.40f, 1.2f, 3.65f);
-    scene.addObject(smallBoxPos);
+    AffineMatrix smallBoxPlacement =
+        AffineMatrix::translate(Vector3(3.40f, 1.2f, 3.65f)) * AffineMatrix::rotate(-18.0f, Vector3(0.0f, 1.0f, 0.0f));
+    scene.addObject(new OrientedBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 1.65f, 0.30f),
+                                    smallBoxPlacement, grayMaterial.get()));
     
     // Bloco grande (com rotação)
-    Box* largeBox = new Box(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 3.30f, 1.65f), grayMaterial.get());
-    Rotate* rotatedLargeBox = new Rotate(largeBox, 22.5f, 0.0f, 1.0f, 0.0f);
-    Translate* largeBoxPos = new Translate(rotatedLargeBox, 0.65f, 0.0f, 1.30f);
-    scene.addObject(largeBoxPos);
+    AffineMatrix largeBoxPlacement =
+        AffineMatrix::translate(Vector3(0.65f, 0.0f, 1.30f)) * AffineMatrix::rotate(22.5f, Vector3(0.0f, 1.0f, 0.0f));
+    scene.addObject(new OrientedBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 3.30f, 1.65f),
+                                    largeBoxPlacement, grayMaterial.get()));
     
     // Fonte de luz pontual
     Vector3 lightPosition(2.775f, 5.55f, 2.775f);
@@ -107,14 +106,20 @@ int main() {
     // Luz ambiente
     scene.setAmbientLight(AmbientLight(0.3f, 0.3f, 0.3f));
     
+    // Construir a estrutura de aceleração
+    scene.build();
+    std::cout << "Estruturas de aceleração: " << scene.accelerationMemory() << " bytes" << std::endl;
+    
     // Renderizar a cena
     Renderer renderer(imageWidth, imageHeight, samplesPerPixel);
-    std::vector<std::vector<Color>> pixels = renderer.render(scene, camera);
+    // A imagem PNG é gravada em faixas durante a renderização
+    PNGWriter writer("cornell_box.png", renderer.exposure);
+    Framebuffer image = renderer.render(scene, camera, &writer);
     
-    // Salvar a imagem
-    renderer.saveToPPM(pixels, "cornell_box.ppm");
+    // Radiância linear em ponto flutuante, para pós-processamento
+    renderer.saveToPFM(image, "cornell_box.pfm");
     
-    std::cout << "Imagem salva como cornell_box.ppm" << std::endl;
+    std::cout << "Imagem salva como cornell_box.png (cornell_box.pfm em HDR)" << std::endl;
     
     return 0;
 } 
\ No newline at end of file
@@ -7,8 +7,7 @@
 #include "../include/geometry/Sphere.h"
 #include "../include/geometry/Box.h"
 #include "../include/geometry/Scene.h"
-#include "../include/transform/Translate.h"
-#include "../include/transform/Rotate.h"
+#include "../include/geometry/OrientedBox.h"
 #include "../include/light/PointLight.h"
 #include "../include/light/RectLight.h"
 #include "../include/light/AmbientLight.h"
@@ -89,16 +88,16 @@ int main() {
     
     // Blocos dentro da cena (ajustados para corresponder à imagem)
     // Bloco grande (com rotação)
-    Box* largeBox = new Box(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 3.30f, 1.65f), grayMaterial.get());
-    Rotate* rotatedLargeBox = new Rotate(largeBox, 22.5f, 0.0f, 1.0f, 0.0f);
-    Translate* largeBoxPos = new Translate(rotatedLargeBox, 0.65f, 0.0f, 1.30f);
-    scene.addObject(largeBoxPos);
+    AffineMatrix largeBoxPlacement =
+        AffineMatrix::translate(Vector3(0.65f, 0.0f, 1.30f)) * AffineMatrix::rotate(22.5f, Vector3(0.0f, 1.0f, 0.0f));
+    scene.addObject(new OrientedBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 3.30f, 1.65f),
+                                    largeBoxPlacement, grayMaterial.get()));
     
     // Bloco pequeno (com rotação)
-    Box* smallBox = new Box(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 1.65f, 1.65f), grayMaterial.get());
-    Rotate* rotatedSmallBox = new Rotate(smallBox, -18.0f, 0.0f, 1.0f, 0.0f);
-    Translate* smallBoxPos = new Translate(rotatedSmallBox, 3.40f, 0.0f, 3.65f);
-    scene.addObject(smallBoxPos);
+    AffineMatrix smallBoxPlacement =
+        AffineMatrix::translate(Vector3(3.40f, 0.0f, 3.65f)) * AffineMatrix::rotate(-18.0f, Vector3(0.0f, 1.0f, 0.0f));
+    scene.addObject(new OrientedBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.65f, 1.65f, 1.65f),
+                                    smallBoxPlacement, grayMaterial.get()));
     
     // Lâmpada simples embutida no teto (pequena esfera)
     Vector3 lightPosition(2.775f, 5.45f, 2.775f);  // Posição da luz logo abaixo do teto
@@ -128,14 +127,29 @@ int main() {
     // Luz ambiente - ajustada para balancear a cena
     scene.setAmbientLight(AmbientLight(0.15f, 0.15f, 0.15f));
     
+    // Construir a estrutura de aceleração
+    scene.build();
+    std::cout << "Estruturas de aceleração: " << scene.accelerationMemory() << " bytes" << std::endl;
+    
     // Renderizar a cena
     Renderer renderer(imageWidth, imageHeight, samplesPerPixel, maxDepth);
-    std::vector<std::vector<Color>> pixels = renderer.render(scene, camera);
     
-    // Salvar a imagem
-    renderer.saveToPPM(pixels, "cornell_box_reference.ppm");
+    // Amostragem adaptativa: samplesPerPixel passa a ser o máximo por pixel
+    renderer.adaptive = true;
+    renderer.minSamples = 16;
+    renderer.errorThreshold = 0.02f;
+    
+    // A imagem PNG é gravada em faixas durante a renderização
+    PNGWriter writer("enhanced_scene.png", renderer.exposure);
+    Framebuffer image = renderer.render(scene, camera, &writer);
+    
+    // Radiância linear em ponto flutuante, para pós-processamento
+    renderer.saveToPFM(image, "enhanced_scene.pfm");
+    
+    // Amostras usadas por pixel
+    renderer.saveSampleHeatmap(image, "enhanced_scene_samples.png");
     
-    std::cout << "Imagem salva como cornell_box_reference.ppm" << std::endl;
+    std::cout << "Imagem salva como enhanced_scene.png (enhanced_scene.pfm em HDR)" << std::endl;
     
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef BLAS_H
+#define BLAS_H
+
+#include <vector>
+#include <utility>
+#include "BVH.h"
+#include "../geometry/Primitive.h"
+
+// Estrutura de nível inferior (bottom-level acceleration structure): um
+// conjunto de primitivas no espaço local do objeto com BVH própria. Uma
+// mesma BLAS é compartilhada por todas as instâncias (Instance) que a
+// posicionam na cena; a BVH da Scene, sobre as instâncias, é o nível superior.
+class BLAS {
+public:
+    std::vector<Primitive*> objects;
+    BVH bvh;
+
+    void add(Primitive* object) {
+        objects.push_back(object);
+        bvh.clear();
+    }
+
+    // Constrói a BVH; deve ser chamado depois de adicionar as primitivas
+    void build() {
+        std::vector<AABB> bounds(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            bounds[i] = objects[i]->boundingBox();
+        }
+        bvh.build(std::move(bounds));
+    }
+
+    // Memória da BVH e das estruturas das primitivas, em bytes
+    size_t memoryUsage() const {
+        size_t total = bvh.memoryUsage();
+        for (size_t i = 0; i < objects.size(); i++) total += objects[i]->accelerationMemory();
+        return total;
+    }
+
+    AABB bounds() const {
+        return bvh.isBuilt() ? bvh.nodes[0].bounds : AABB();
+    }
+
+    // Com um único objeto (caso comum de Instance::flatten) a BVH seria só
+    // uma caixa a mais por raio, então o objeto é testado diretamente
+    bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const {
+        if (objects.size() == 1) return objects[0]->hit(ray, tMin, tMax, record);
+        HitRecord tempRecord;
+        return bvh.intersect(ray, tMin, tMax, [&](int index, float& closestSoFar) {
+            if (objects[index]->hit(ray, tMin, closestSoFar, tempRecord)) {
+                closestSoFar = tempRecord.t;
+                record = tempRecord;
+                return true;
+            }
+            return false;
+        });
+    }
+
+    bool occluded(const Ray& ray, float tMin, float tMax) const {
+        if (objects.size() == 1) return objects[0]->occluded(ray, tMin, tMax);
+        return bvh.occluded(ray, tMin, tMax, [&](int index) {
+            return objects[index]->occluded(ray, tMin, tMax);
+        });
+    }
+
+    // Interseção de um pacote (já no espaço local) nas lanes ativas; as
+    // interseções são registradas em result com o índice "index" da instância
+    void hitPacket(const RayPacket& packet, float tMin, PacketHit& result, int index) const {
+        if (objects.size() == 1) {
+            objects[0]->hitPacket(packet, packet.active, tMin, result, index);
+            return;
+        }
+        bvh.intersectPacket(packet, tMin, result, [&](int object, const PacketMask& mask) {
+            objects[object]->hitPacket(packet, mask, tMin, result, index);
+        });
+    }
+
+    PacketMask occludedPacket(const RayPacket& packet, float tMin, const PacketFloat& tMax) const {
+        if (objects.size() == 1) return objects[0]->occludedPacket(packet, packet.active, tMin, tMax);
+        return bvh.occludedPacket(packet, tMin, tMax, [&](int object, const PacketMask& mask) {
+            return objects[object]->occludedPacket(packet, mask, tMin, tMax);
+        });
+    }
+};
+
+#endif // BLAS_H
@@ -0,0 +1,922 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "BVHNode.h"
+#include "WideBVH.h"
+#include "QuantizedBVHNode.h"
+
+// Algoritmo de construção da BVH: qualidade da árvore contra velocidade
+enum class BVHBuildMode {
+    SAH,    // SAH em bins, em tarefas paralelas: melhor árvore (padrão)
+    LBVH,   // Ordenação por código de Morton: construção bem mais rápida, travessia um pouco mais lenta
+    Lazy    // Só os níveis de cima na construção; cada subárvore é construída (SAH) na primeira visita
+};
+
+// Formato dos nós usados nas consultas: velocidade contra memória
+enum class BVHLayout {
+    Binary,     // Árvore binária, 32 bytes por nó
+    Wide,       // BVHWidth filhos por nó com caixas em float (padrão)
+    Compressed  // 4 filhos em 64 bytes, caixas quantizadas em 8 bits, sem a árvore binária: menor memória
+};
+
+// Hierarquia de volumes envolventes construída com a heurística de área de
+// superfície (SAH) em bins. A BVH só conhece as caixas dos primitivos; a
+// interseção com cada primitivo é delegada a uma função fornecida pelo chamador,
+// o que permite reutilizá-la para objetos da cena, triângulos etc.
+// A árvore é construída binária ("nodes") e achatada no formato de "layout"
+// ("wide" ou "compressed") usado pelas consultas. No formato comprimido só a
+// raiz da árvore binária é mantida, para a caixa da BVH.
+// Na construção Lazy a árvore binária fica incompleta: nós pendentes (com
+// a caixa já calculada) guardam o intervalo dos seus primitivos e são
+// construídos pela thread do primeiro raio que entra na caixa; um flag
+// atômico por nó em LazyState diz quando o nó pode ser lido. As consultas
+// usam então a árvore binária, qualquer que seja o layout.
+class BVH {
+public:
+    static const int NumBins = 16;          // Número de bins da SAH
+    static const int StackSize = 128;       // Pilha de travessia (altura máxima: MaxSAHDepth + log2(n) < 96)
+    static const int MaxSAHDepth = 64;      // Após essa profundidade, divide pela mediana
+    static const int ParallelTaskSize = 4096;   // Nós com mais primitivos viram tarefas OpenMP
+    static const int ParallelChunkSize = 65536; // Varreduras maiores são divididas em blocos paralelos
+    static const int LazySubtreeSize = 16384;   // Subárvores com até esse número de primitivos ficam pendentes
+    static const int LazyTopNodes = 256;        // ... ou com até 1/LazyTopNodes dos primitivos (cenas enormes)
+    static const int LazyLockCount = 64;        // Travas da construção sob demanda (nó % LazyLockCount)
+
+    // nodes e indices são mutable porque a construção Lazy completa as
+    // subárvores pendentes dentro das consultas const, sob as travas de LazyState
+    mutable std::vector<BVHNode> nodes;     // Nós em layout plano (raiz em nodes[0])
+    mutable std::vector<int> indices;       // Índices dos primitivos, ordenados por folha
+    int maxLeafSize;                // Máximo de primitivos por folha
+    BVHBuildMode buildMode;         // Algoritmo usado por build
+    BVHLayout layout;               // Formato dos nós gerado por build
+    WideBVH<WideBVHNode<BVHWidth>> wide;        // Versão larga de "nodes" (layout Wide)
+    WideBVH<QuantizedBVHNode> compressed;       // Versão comprimida (layout Compressed)
+
+    BVH(int maxLeafSize = 4, BVHBuildMode buildMode = BVHBuildMode::SAH, BVHLayout layout = BVHLayout::Wide)
+        : maxLeafSize(maxLeafSize), buildMode(buildMode), layout(layout), sahArea(0.0), builtCost(0.0f) {}
+
+    bool isBuilt() const { return !nodes.empty(); }
+
+    // Formato usado pelas consultas depois de build, que pode diferir de
+    // "layout": Compressed volta para Wide quando as folhas não cabem nos
+    // nós comprimidos, e a construção Lazy consulta a árvore binária
+    BVHLayout builtLayout() const {
+        if (!compressed.empty()) return BVHLayout::Compressed;
+        if (!wide.empty()) return BVHLayout::Wide;
+        return BVHLayout::Binary;
+    }
+
+    int primitiveCount() const { return static_cast<int>(indices.size()); }
+
+    void clear() {
+        nodes.clear();
+        indices.clear();
+        wide.clear();
+        compressed.clear();
+        wideSlots.clear();
+        parents.clear();
+        primitiveLeaf.clear();
+        refitMark.clear();
+        lazy.reset();
+        sahArea = 0.0;
+        builtCost = 0.0f;
+    }
+
+    // Memória ocupada pelos nós de todos os formatos mantidos (e pelos
+    // vínculos usados em refit), em bytes
+    size_t nodeMemory() const {
+        return nodes.capacity() * sizeof(BVHNode) + wide.byteSize() + compressed.byteSize() +
+               (wideSlots.capacity() + parents.capacity() + primitiveLeaf.capacity()) * sizeof(int) +
+               refitMark.capacity();
+    }
+
+    // Subárvores ainda não construídas (só na construção Lazy)
+    int pendingSubtrees() const { return lazy ? lazy->pending.load() : 0; }
+
+    // Custo SAH da árvore binária, relativo à área da raiz: travessia (1 por
+    // nó interno) mais interseções (1 por primitivo), ponderadas pela área
+    float sahCost() const {
+        float rootArea = nodes.empty() ? 0.0f : nodes[0].bounds.surfaceArea();
+        return rootArea > 0.0f ? static_cast<float>(sahArea / rootArea) : 0.0f;
+    }
+
+    // Custo SAH atual dividido pelo custo logo após a construção: cresce
+    // quando refit alarga as caixas sem mudar a topologia
+    float degradation() const {
+        return builtCost > 0.0f ? sahCost() / builtCost : 1.0f;
+    }
+
+    // Atualiza a árvore depois que as caixas dos primitivos em "changed"
+    // mudaram (novas caixas em primitiveBounds), sem mudar a topologia: só
+    // os nós no caminho de cada folha alterada até a raiz são recalculados,
+    // de baixo para cima, e as subárvores estáticas não são visitadas. O
+    // layout largo é atualizado junto. Retorna false, sem alterar nada, no
+    // layout comprimido (que não mantém a árvore binária) e na construção
+    // Lazy (que guarda as caixas da construção): nesses casos a BVH deve ser
+    // reconstruída.
+    bool refit(const std::vector<AABB>& primitiveBounds, const std::vector<int>& changed) {
+        if (nodes.empty() || !compressed.empty() || lazy) return false;
+        if (parents.empty()) buildRefitLinks();
+
+        std::vector<int> dirty;
+        for (size_t i = 0; i < changed.size(); i++) {
+            int node = primitiveLeaf[changed[i]];
+            while (node >= 0 && !refitMark[node]) {
+                refitMark[node] = 1;
+                dirty.push_back(node);
+                node = parents[node];
+            }
+        }
+
+        // Os filhos sempre têm índice maior que o pai: ordem decrescente é de baixo para cima
+        std::sort(dirty.begin(), dirty.end(), std::greater<int>());
+        for (size_t i = 0; i < dirty.size(); i++) {
+            BVHNode& node = nodes[dirty[i]];
+            sahArea -= nodeCost(node);
+            AABB bounds;
+            if (node.isLeaf()) {
+                for (int k = 0; k < node.count; k++) bounds.expand(primitiveBounds[indices[node.leftFirst + k]]);
+            } else {
+                bounds = surroundingBox(nodes[node.leftFirst].bounds, nodes[node.leftFirst + 1].bounds);
+            }
+            node.bounds = bounds;
+            sahArea += nodeCost(node);
+            refitMark[dirty[i]] = 0;
+            if (!wideSlots.empty() && wideSlots[dirty[i]] >= 0) wide.setChildBounds(wideSlots[dirty[i]], bounds);
+        }
+        return true;
+    }
+
+    // Memória total da estrutura: nós, índices dos primitivos e, na
+    // construção Lazy, as caixas e centróides guardados para as subárvores
+    size_t memoryUsage() const {
+        size_t total = nodeMemory() + indices.capacity() * sizeof(int);
+        if (lazy) {
+            total += lazy->ownedBounds.capacity() * sizeof(AABB) + lazy->centroids.capacity() * sizeof(Vector3) +
+                     lazy->topNodes * sizeof(std::atomic<bool>);
+        }
+        return total;
+    }
+
+    // Constrói a hierarquia a partir das caixas dos primitivos, com o
+    // algoritmo de buildMode. As duas construções usam as threads do OpenMP;
+    // a árvore resultante não depende do número de threads (só a posição
+    // dos nós no vetor). Na construção Lazy só os nós com mais de
+    // max(LazySubtreeSize, n / LazyTopNodes) primitivos são divididos aqui,
+    // e primitiveBounds, sem cópia, é lido de novo ao construir as
+    // subárvores pendentes: o vetor deve continuar válido e inalterado até
+    // o próximo build ou clear (como Scene::objectBounds). Caixas
+    // temporárias devem ser passadas com std::move, e ficam com a BVH.
+    void build(const std::vector<AABB>& primitiveBounds) {
+        clear();
+        int n = static_cast<int>(primitiveBounds.size());
+        if (n == 0) return;
+
+        std::vector<Vector3> centroids(n);
+        indices.resize(n);
+        #pragma omp parallel for if (n >= ParallelChunkSize)
+        for (int i = 0; i < n; i++) {
+            // Caixa vazia (ex.: malha sem triângulos) teria centróide NaN,
+            // o que estraga os bins; o primitivo vai para a origem, onde
+            // nunca é atingido
+            centroids[i] = primitiveBounds[i].isEmpty() ? Vector3(0.0f, 0.0f, 0.0f) : primitiveBounds[i].centroid();
+            indices[i] = i;
+        }
+
+        // Os filhos são alocados aos pares num vetor já dimensionado
+        nodes.resize(2 * n - 1);
+        nodes[0].leftFirst = 0;
+        nodes[0].count = n;
+        if (buildMode == BVHBuildMode::Lazy) {
+            buildLazy(primitiveBounds, centroids);
+            return;
+        }
+        std::atomic<int> nodeCount(1);
+        BuildState state = {primitiveBounds, centroids, nodeCount, 0, nullptr, true};
+
+        if (buildMode == BVHBuildMode::LBVH) {
+            buildMorton(state);
+        } else {
+            #pragma omp parallel
+            #pragma omp single
+            buildSAH(state, 0, 0);
+        }
+        nodes.resize(nodeCount.load());
+        nodes.shrink_to_fit();
+        for (size_t i = 0; i < nodes.size(); i++) sahArea += nodeCost(nodes[i]);
+        builtCost = sahCost();
+
+        // Folhas grandes demais para os nós comprimidos (mais de
+        // QuantizedBVHNode::MaxLeafCount primitivos, ou mais de MaxPrimitives
+        // no total) caem no formato largo; builtLayout informa o resultado
+        if (layout == BVHLayout::Compressed && compressed.build(nodes)) {
+            nodes.resize(1);
+            nodes.shrink_to_fit();
+            return;
+        }
+        if (layout != BVHLayout::Binary) wide.build(nodes, &wideSlots);
+    }
+
+    // Mesma construção, com caixas que a BVH pode guardar sem cópia na
+    // construção Lazy
+    void build(std::vector<AABB>&& primitiveBounds) {
+        if (buildMode != BVHBuildMode::Lazy) return build(static_cast<const std::vector<AABB>&>(primitiveBounds));
+        std::vector<AABB> owned;
+        owned.swap(primitiveBounds);
+        build(owned);
+        if (lazy) {
+            lazy->ownedBounds.swap(owned);
+            lazy->bounds = &lazy->ownedBounds;
+        }
+    }
+
+    // Busca a interseção mais próxima. hitPrimitive(index, tMax) deve testar o
+    // primitivo "index" no intervalo [tMin, tMax], reduzir tMax (passado por
+    // referência) quando houver interseção e retornar true nesse caso.
+    template <typename HitFunc>
+    bool intersect(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+        if (!wide.empty()) return wide.intersect(ray, tMin, tMax, indices.data(), hitPrimitive);
+        if (!compressed.empty()) return compressed.intersect(ray, tMin, tMax, indices.data(), hitPrimitive);
+
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float tEntry;
+        if (!nodes[0].bounds.hit(ray, invDir, tMin, tMax, tEntry)) return false;
+
+        struct StackEntry { int node; float tEntry; };
+        StackEntry stack[StackSize];
+        int stackPtr = 0;
+        int current = 0;
+        bool hitAnything = false;
+
+        while (true) {
+            if (lazy) expandPending(current);
+            const BVHNode& node = nodes[current];
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count; i++) {
+                    if (hitPrimitive(indices[node.leftFirst + i], tMax)) {
+                        hitAnything = true;
+                    }
+                }
+            } else {
+                // Visitar primeiro o filho mais próximo
+                int c0 = node.leftFirst;
+                int c1 = node.leftFirst + 1;
+                float t0, t1;
+                bool hit0 = nodes[c0].bounds.hit(ray, invDir, tMin, tMax, t0);
+                bool hit1 = nodes[c1].bounds.hit(ray, invDir, tMin, tMax, t1);
+
+                if (hit0 && hit1) {
+                    if (t1 < t0) {
+                        std::swap(c0, c1);
+                        std::swap(t0, t1);
+                    }
+                    assert(stackPtr < StackSize);
+                    stack[stackPtr++] = StackEntry{c1, t1};
+                    current = c0;
+                    continue;
+                }
+                if (hit0) { current = c0; continue; }
+                if (hit1) { current = c1; continue; }
+            }
+
+            // Desempilhar, descartando nós que começam depois da interseção atual
+            bool found = false;
+            while (stackPtr > 0) {
+                const StackEntry& entry = stack[--stackPtr];
+                if (entry.tEntry <= tMax) {
+                    current = entry.node;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) break;
+        }
+
+        return hitAnything;
+    }
+
+    // Busca a interseção mais próxima de cada raio de um pacote. Um nó é
+    // visitado se alguma lane ativa atinge a sua caixa antes de result.t;
+    // hitPrimitive(index, mask) testa o primitivo nas lanes de "mask" e
+    // atualiza result. Os filhos são visitados na ordem dada pela direção
+    // do primeiro raio ativo, o que vale para todo o pacote quando os raios
+    // são coerentes.
+    template <typename HitFunc>
+    void intersectPacket(const RayPacket& packet, float tMin, PacketHit& result, HitFunc hitPrimitive) const {
+        if (nodes.empty() || packet.active.none()) return;
+        if (!wide.empty()) return wide.intersectPacket(packet, tMin, result, indices.data(), hitPrimitive);
+        if (!compressed.empty()) return compressed.intersectPacket(packet, tMin, result, indices.data(), hitPrimitive);
+
+        Ray lead = packet.ray(lowestLane(packet.active.bits()));
+        bool negative[3] = {lead.direction.x < 0.0f, lead.direction.y < 0.0f, lead.direction.z < 0.0f};
+
+        int stack[StackSize];
+        int stackPtr = 0;
+        stack[stackPtr++] = 0;
+
+        while (stackPtr > 0) {
+            int index = stack[--stackPtr];
+            const BVHNode& node = nodes[index];
+            PacketMask mask = packet.active & hitBoxPacket(node.bounds, packet, tMin, result.t);
+            if (mask.none()) continue;
+            if (lazy) expandPending(index);
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count; i++) {
+                    hitPrimitive(indices[node.leftFirst + i], mask);
+                }
+            } else {
+                // Eixo de maior separação entre os filhos decide a ordem
+                int c0 = node.leftFirst;
+                int c1 = node.leftFirst + 1;
+                Vector3 separation = nodes[c1].bounds.centroid() - nodes[c0].bounds.centroid();
+                float sx = std::fabs(separation.x), sy = std::fabs(separation.y), sz = std::fabs(separation.z);
+                int axis = sx > sy && sx > sz ? 0 : (sy > sz ? 1 : 2);
+                if ((separation[axis] < 0.0f) != negative[axis]) std::swap(c0, c1);
+                assert(stackPtr + 2 <= StackSize);
+                stack[stackPtr++] = c1;
+                stack[stackPtr++] = c0;
+            }
+        }
+    }
+
+    // Consulta de oclusão para um pacote: retorna as lanes ativas bloqueadas
+    // no intervalo [tMin, tMax]. hitPrimitive(index, mask) retorna as lanes
+    // de "mask" que o primitivo bloqueia; lanes bloqueadas deixam de ser
+    // testadas e a travessia termina quando todas estão bloqueadas.
+    template <typename HitFunc>
+    PacketMask occludedPacket(const RayPacket& packet, float tMin, const PacketFloat& tMax,
+                              HitFunc hitPrimitive) const {
+        PacketMask blocked;
+        if (nodes.empty()) return blocked;
+        if (!wide.empty()) return wide.occludedPacket(packet, tMin, tMax, indices.data(), hitPrimitive);
+        if (!compressed.empty()) return compressed.occludedPacket(packet, tMin, tMax, indices.data(), hitPrimitive);
+
+        int stack[StackSize];
+        int stackPtr = 0;
+        stack[stackPtr++] = 0;
+
+        while (stackPtr > 0) {
+            PacketMask pending = packet.active & !blocked;
+            if (pending.none()) break;
+
+            int index = stack[--stackPtr];
+            const BVHNode& node = nodes[index];
+            PacketMask mask = pending & hitBoxPacket(node.bounds, packet, tMin, tMax);
+            if (mask.none()) continue;
+            if (lazy) expandPending(index);
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count && mask.any(); i++) {
+                    blocked = blocked | hitPrimitive(indices[node.leftFirst + i], mask);
+                    mask = mask & !blocked;
+                }
+            } else {
+                assert(stackPtr + 2 <= StackSize);
+                stack[stackPtr++] = node.leftFirst + 1;
+                stack[stackPtr++] = node.leftFirst;
+            }
+        }
+
+        return blocked;
+    }
+
+    // Busca qualquer interseção no intervalo (consulta de oclusão).
+    // hitPrimitive(index) retorna true se o primitivo bloqueia o raio;
+    // a travessia termina no primeiro bloqueio encontrado.
+    template <typename HitFunc>
+    bool occluded(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+        if (!wide.empty()) return wide.occluded(ray, tMin, tMax, indices.data(), hitPrimitive);
+        if (!compressed.empty()) return compressed.occluded(ray, tMin, tMax, indices.data(), hitPrimitive);
+
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        int stack[StackSize];
+        int stackPtr = 0;
+        stack[stackPtr++] = 0;
+
+        while (stackPtr > 0) {
+            int index = stack[--stackPtr];
+            const BVHNode& node = nodes[index];
+            float tEntry;
+            if (!node.bounds.hit(ray, invDir, tMin, tMax, tEntry)) continue;
+            if (lazy) expandPending(index);
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count; i++) {
+                    if (hitPrimitive(indices[node.leftFirst + i])) return true;
+                }
+            } else {
+                assert(stackPtr + 2 <= StackSize);
+                stack[stackPtr++] = node.leftFirst + 1;
+                stack[stackPtr++] = node.leftFirst;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::vector<int> wideSlots;     // Lugar (nó * largura + filho) de cada nó binário em "wide", ou -1
+    std::vector<int> parents;       // Pai de cada nó (-1 na raiz), criado no primeiro refit
+    std::vector<int> primitiveLeaf; // Folha de cada primitivo, criado no primeiro refit
+    std::vector<char> refitMark;    // Nós já marcados no refit atual
+    double sahArea;                 // Soma de área * custo de todos os nós (sahCost sem normalizar)
+    float builtCost;                // sahCost logo após build
+
+    // Estado da construção Lazy, mantido enquanto a BVH existe: as caixas
+    // (do chamador, ou próprias se recebidas com std::move) e os centróides
+    // dos primitivos, o contador de nós alocados em "nodes", as travas das
+    // subárvores e, para os nós da construção inicial, se já podem ser lidos
+    struct LazyState {
+        const std::vector<AABB>* bounds;
+        std::vector<AABB> ownedBounds;
+        std::vector<Vector3> centroids;
+        std::atomic<int> nodeCount;
+        std::atomic<int> pending;
+        int topNodes;                               // Nós alocados pela construção inicial
+        std::vector<int> depths;                    // depths[i]: profundidade do nó i (i < topNodes) se pendente
+        std::unique_ptr<std::atomic<bool>[]> ready; // ready[i]: nó i (i < topNodes) completo
+        std::mutex locks[LazyLockCount];
+    };
+    std::unique_ptr<LazyState> lazy;
+
+    static double nodeCost(const BVHNode& node) {
+        return static_cast<double>(node.bounds.surfaceArea()) * (node.isLeaf() ? node.count : 1);
+    }
+
+    void buildRefitLinks() {
+        parents.assign(nodes.size(), -1);
+        primitiveLeaf.assign(indices.size(), -1);
+        refitMark.assign(nodes.size(), 0);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const BVHNode& node = nodes[i];
+            if (node.isLeaf()) {
+                for (int k = 0; k < node.count; k++) primitiveLeaf[indices[node.leftFirst + k]] = static_cast<int>(i);
+            } else {
+                parents[node.leftFirst] = static_cast<int>(i);
+                parents[node.leftFirst + 1] = static_cast<int>(i);
+            }
+        }
+    }
+
+    // Dados compartilhados pelas tarefas de construção
+    struct BuildState {
+        const std::vector<AABB>& bounds;
+        const std::vector<Vector3>& centroids;
+        std::atomic<int>& nodeCount;
+        int deferSize;      // Nós com até esse número de primitivos ficam pendentes (0: nenhum)
+        int* depths;        // Profundidade de cada nó deixado pendente (só com deferSize)
+        bool parallel;      // Dividir os nós grandes em tarefas OpenMP
+    };
+
+    // Bins da SAH nos três eixos para um bloco de primitivos
+    struct BinSet {
+        AABB bounds[3][NumBins];
+        int counts[3][NumBins];
+    };
+
+    // Número de blocos para varrer "count" primitivos (1 se forem poucos)
+    static int chunkCount(int count) {
+        return std::max(1, std::min(64, count / ParallelChunkSize));
+    }
+
+    // Executa body(início, fim, bloco) sobre [first, first + count) em
+    // "chunks" blocos, como tarefas OpenMP, e espera todos terminarem
+    template <typename Body>
+    static void forChunks(int first, int count, int chunks, Body body) {
+        if (chunks == 1) {
+            body(first, first + count, 0);
+            return;
+        }
+        for (int c = 0; c < chunks; c++) {
+            int begin = first + static_cast<int>(static_cast<long long>(count) * c / chunks);
+            int end = first + static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+            #pragma omp task firstprivate(begin, end, c)
+            body(begin, end, c);
+        }
+        #pragma omp taskwait
+    }
+
+    // Construção SAH de uma subárvore: nós grandes dividem os filhos em
+    // tarefas; subárvores pequenas seguem numa pilha explícita na mesma tarefa
+    void buildSAH(BuildState& state, int nodeIndex, int depth) const {
+        int count = nodes[nodeIndex].count;
+        int left = subdivide(state, nodeIndex, depth);
+        if (left < 0) return;
+
+        if (count >= ParallelTaskSize && state.parallel) {
+            #pragma omp task shared(state)
+            buildSAH(state, left, depth + 1);
+            buildSAH(state, left + 1, depth + 1);
+            return;
+        }
+
+        struct BuildTask { int node; int depth; };
+        BuildTask tasks[2 * MaxSAHDepth + 64];
+        int taskCount = 0;
+        tasks[taskCount++] = BuildTask{left + 1, depth + 1};
+        tasks[taskCount++] = BuildTask{left, depth + 1};
+        while (taskCount > 0) {
+            BuildTask task = tasks[--taskCount];
+            int child = subdivide(state, task.node, task.depth);
+            if (child >= 0) {
+                tasks[taskCount++] = BuildTask{child + 1, task.depth + 1};
+                tasks[taskCount++] = BuildTask{child, task.depth + 1};
+            }
+        }
+    }
+
+    // Construção Lazy: os nós grandes são divididos como na SAH (em tarefas)
+    // e os demais ficam pendentes (marcados aqui com count negativo). "nodes"
+    // é então realocado com o tamanho exato da árvore completa, para que as
+    // subárvores sejam construídas sem realocar.
+    void buildLazy(const std::vector<AABB>& primitiveBounds, std::vector<Vector3>& centroids) {
+        int n = primitiveCount();
+        lazy.reset(new LazyState());
+        lazy->bounds = &primitiveBounds;
+        lazy->centroids.swap(centroids);
+        lazy->nodeCount = 1;
+        int deferSize = n / LazyTopNodes;
+        if (deferSize < LazySubtreeSize) deferSize = LazySubtreeSize;
+        lazy->depths.resize(nodes.size());
+        BuildState state = {primitiveBounds, lazy->centroids, lazy->nodeCount, deferSize, lazy->depths.data(), true};
+        #pragma omp parallel
+        #pragma omp single
+        buildSAH(state, 0, 0);
+
+        // Uma subárvore pendente de k primitivos ainda aloca até 2k - 2 nós,
+        // mais o nó auxiliar de buildPending
+        int used = lazy->nodeCount.load();
+        int reserved = used;
+        int pending = 0;
+        lazy->topNodes = used;
+        lazy->ready.reset(new std::atomic<bool>[used]);
+        for (int i = 0; i < used; i++) {
+            bool isPending = nodes[i].count < 0;
+            if (isPending) {
+                reserved += -2 * nodes[i].count - 1;
+                pending++;
+            }
+            lazy->ready[i].store(!isPending, std::memory_order_relaxed);
+        }
+        lazy->pending = pending;
+        lazy->depths.resize(used);
+        lazy->depths.shrink_to_fit();
+
+        // Cópia só dos nós já construídos para um vetor do tamanho exato
+        // (o de build tem 2n - 1 nós, que podem sobrar ou faltar)
+        std::vector<BVHNode> exact;
+        exact.reserve(reserved);
+        exact.assign(nodes.begin(), nodes.begin() + used);
+        exact.resize(reserved);
+        nodes.swap(exact);
+        for (int i = 0; i < used; i++) sahArea += nodeCost(nodes[i]);
+        builtCost = sahCost();
+    }
+
+    // Constrói o nó se ele ainda estiver pendente. Os nós criados depois da
+    // construção inicial (dentro das subárvores) nunca são pendentes.
+    void expandPending(int index) const {
+        if (index < lazy->topNodes && !lazy->ready[index].load(std::memory_order_acquire)) buildPending(index);
+    }
+
+    // Constrói a subárvore pendente em "index" com a SAH, na thread do
+    // primeiro raio que a visita; as demais que chegam ao nó esperam pela
+    // trava. A construção continua da profundidade do nó (e não de 0), para
+    // que a altura total respeite StackSize. A subárvore é montada a partir de um nó auxiliar e só então
+    // copiada para "index", e ready[index] é escrito por último (release):
+    // quem o lê com acquire em expandPending e o vê verdadeiro também vê o
+    // nó e os filhos completos. Antes disso nenhuma consulta lê o nó, a não
+    // ser a caixa, que não muda.
+    void buildPending(int index) const {
+        LazyState& state = *lazy;
+        std::lock_guard<std::mutex> guard(state.locks[index % LazyLockCount]);
+        if (state.ready[index].load(std::memory_order_relaxed)) return;    // Construída por outra thread durante a espera
+
+        BVHNode& node = nodes[index];
+        int scratch = state.nodeCount.fetch_add(1);
+        nodes[scratch].leftFirst = node.leftFirst;
+        nodes[scratch].count = -node.count;
+        BuildState build = {*state.bounds, state.centroids, state.nodeCount, 0, nullptr, false};
+        buildSAH(build, scratch, state.depths[index]);
+
+        node.leftFirst = nodes[scratch].leftFirst;
+        node.count = nodes[scratch].count;
+        state.ready[index].store(true, std::memory_order_release);
+        state.pending.fetch_sub(1);
+    }
+
+    // Divide um nó usando a SAH em bins. Retorna o índice do filho esquerdo,
+    // ou -1 se o nó se tornou uma folha. Nós grandes calculam as caixas e os
+    // bins em blocos paralelos, combinados depois (o resultado é o mesmo).
+    int subdivide(BuildState& state, int nodeIndex, int depth) const {
+        const std::vector<AABB>& primitiveBounds = state.bounds;
+        const std::vector<Vector3>& centroids = state.centroids;
+        int first = nodes[nodeIndex].leftFirst;
+        int count = nodes[nodeIndex].count;
+        int chunks = chunkCount(count);
+
+        // Caixa do nó e caixa dos centróides (resultados parciais na pilha
+        // quando há um só bloco, o caso de quase todos os nós)
+        AABB localPartial[2];
+        std::vector<AABB> heapPartial(chunks > 1 ? 2 * chunks : 0);
+        AABB* partial = chunks > 1 ? &heapPartial[0] : localPartial;
+        forChunks(first, count, chunks, [&](int begin, int end, int c) {
+            for (int i = begin; i < end; i++) {
+                partial[2 * c].expand(primitiveBounds[indices[i]]);
+                partial[2 * c + 1].expand(centroids[indices[i]]);
+            }
+        });
+        AABB bounds, centroidBounds;
+        for (int c = 0; c < chunks; c++) {
+            bounds.expand(partial[2 * c]);
+            centroidBounds.expand(partial[2 * c + 1]);
+        }
+        nodes[nodeIndex].bounds = bounds;
+
+        if (count <= 1) return -1;
+        if (count > maxLeafSize && count <= state.deferSize) {
+            nodes[nodeIndex].count = -count;
+            state.depths[nodeIndex] = depth;
+            return -1;
+        }
+
+        int mid = -1;
+        Vector3 cMin = centroidBounds.min;
+        Vector3 cExtent = centroidBounds.extent();
+
+        if (depth < MaxSAHDepth) {
+            // Bins dos três eixos numa única passagem pelos primitivos
+            float scale[3];
+            for (int axis = 0; axis < 3; axis++) {
+                scale[axis] = cExtent[axis] > 0.0f ? NumBins / cExtent[axis] : 0.0f;
+            }
+            BinSet localBins;
+            std::vector<BinSet> heapBins(chunks > 1 ? chunks : 0);
+            BinSet* binSets = chunks > 1 ? &heapBins[0] : &localBins;
+            forChunks(first, count, chunks, [&](int begin, int end, int c) {
+                BinSet& bins = binSets[c];
+                std::fill(&bins.counts[0][0], &bins.counts[0][0] + 3 * NumBins, 0);
+                for (int i = begin; i < end; i++) {
+                    int index = indices[i];
+                    for (int axis = 0; axis < 3; axis++) {
+                        int b = binIndex(centroids[index][axis], cMin[axis], scale[axis]);
+                        bins.counts[axis][b]++;
+                        bins.bounds[axis][b].expand(primitiveBounds[index]);
+                    }
+                }
+            });
+            BinSet& bins = binSets[0];
+            for (int c = 1; c < chunks; c++) {
+                for (int axis = 0; axis < 3; axis++) {
+                    for (int b = 0; b < NumBins; b++) {
+                        bins.counts[axis][b] += binSets[c].counts[axis][b];
+                        bins.bounds[axis][b].expand(binSets[c].bounds[axis][b]);
+                    }
+                }
+            }
+
+            // Avaliar a SAH em cada eixo
+            float bestCost = std::numeric_limits<float>::infinity();
+            int bestAxis = -1;
+            int bestSplit = -1;
+
+            for (int axis = 0; axis < 3; axis++) {
+                if (cExtent[axis] <= 0.0f) continue;
+                const AABB* binBounds = bins.bounds[axis];
+                const int* binCounts = bins.counts[axis];
+
+                // Varredura da direita para a esquerda acumulando áreas
+                float rightArea[NumBins - 1];
+                int rightCount[NumBins - 1];
+                AABB accum;
+                int accumCount = 0;
+                for (int b = NumBins - 1; b > 0; b--) {
+                    accum.expand(binBounds[b]);
+                    accumCount += binCounts[b];
+                    rightArea[b - 1] = accum.surfaceArea();
+                    rightCount[b - 1] = accumCount;
+                }
+
+                // Varredura da esquerda para a direita avaliando cada plano
+                accum = AABB();
+                accumCount = 0;
+                for (int b = 0; b < NumBins - 1; b++) {
+                    accum.expand(binBounds[b]);
+                    accumCount += binCounts[b];
+                    if (accumCount == 0 || rightCount[b] == 0) continue;
+                    float cost = accum.surfaceArea() * accumCount + rightArea[b] * rightCount[b];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = b;
+                    }
+                }
+            }
+
+            // Custo relativo: travessia (1) + interseções ponderadas pela área
+            float parentArea = bounds.surfaceArea();
+            float leafCost = static_cast<float>(count);
+            float splitCost = parentArea > 0.0f ? 1.0f + bestCost / parentArea : leafCost;
+
+            if (bestAxis < 0) {
+                // Centróides coincidentes: não há plano válido, dividir ao meio
+                if (count <= maxLeafSize) return -1;
+                mid = first + count / 2;
+            } else if (count <= maxLeafSize && leafCost <= splitCost) {
+                return -1;
+            } else {
+                float axisScale = scale[bestAxis];
+                float axisMin = cMin[bestAxis];
+                std::vector<int>::iterator pivot = std::partition(
+                    indices.begin() + first, indices.begin() + first + count,
+                    [&](int index) {
+                        return binIndex(centroids[index][bestAxis], axisMin, axisScale) <= bestSplit;
+                    });
+                mid = static_cast<int>(pivot - indices.begin());
+            }
+        } else {
+            // Profundidade excessiva: divisão pela mediana limita a altura da árvore
+            if (count <= maxLeafSize) return -1;
+            int axis = centroidBounds.longestAxis();
+            mid = first + count / 2;
+            std::nth_element(indices.begin() + first, indices.begin() + mid,
+                indices.begin() + first + count,
+                [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+
+        return split(state, nodeIndex, first, mid, first + count);
+    }
+
+    // Transforma o nó em interno com filhos [first, mid) e [mid, end)
+    int split(BuildState& state, int nodeIndex, int first, int mid, int end) const {
+        int leftIndex = state.nodeCount.fetch_add(2);
+        nodes[leftIndex].leftFirst = first;
+        nodes[leftIndex].count = mid - first;
+        nodes[leftIndex + 1].leftFirst = mid;
+        nodes[leftIndex + 1].count = end - mid;
+
+        nodes[nodeIndex].leftFirst = leftIndex;
+        nodes[nodeIndex].count = 0;
+        return leftIndex;
+    }
+
+    // LBVH: os primitivos são ordenados pelo código de Morton do centróide
+    // (curva Z de 30 bits na caixa dos centróides) e cada nó divide seu
+    // intervalo onde muda o bit mais alto em que os códigos diferem. A
+    // divisão é uma busca binária, e as caixas são calculadas na volta da
+    // recursão, então a construção é linear além da ordenação.
+    void buildMorton(BuildState& state) {
+        int n = static_cast<int>(indices.size());
+        int chunks = chunkCount(n);
+        std::vector<AABB> partial(chunks);
+        #pragma omp parallel for if (chunks > 1)
+        for (int c = 0; c < chunks; c++) {
+            int end = static_cast<int>(static_cast<long long>(n) * (c + 1) / chunks);
+            for (int i = static_cast<int>(static_cast<long long>(n) * c / chunks); i < end; i++) {
+                partial[c].expand(state.centroids[i]);
+            }
+        }
+        AABB centroidBounds;
+        for (int c = 0; c < chunks; c++) centroidBounds.expand(partial[c]);
+
+        Vector3 extent = centroidBounds.extent();
+        Vector3 scale(extent.x > 0.0f ? 1023.0f / extent.x : 0.0f, extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+                      extent.z > 0.0f ? 1023.0f / extent.z : 0.0f);
+        std::vector<uint32_t> codes(n);
+        #pragma omp parallel for if (n >= ParallelChunkSize)
+        for (int i = 0; i < n; i++) {
+            Vector3 c = state.centroids[i] - centroidBounds.min;
+            codes[i] = (expandBits(static_cast<uint32_t>(c.x * scale.x)) << 2) |
+                       (expandBits(static_cast<uint32_t>(c.y * scale.y)) << 1) |
+                       expandBits(static_cast<uint32_t>(c.z * scale.z));
+        }
+        radixSort(codes, indices);
+
+        #pragma omp parallel
+        #pragma omp single
+        buildMortonNode(state, codes, 0);
+    }
+
+    void buildMortonNode(BuildState& state, const std::vector<uint32_t>& codes, int nodeIndex) {
+        int first = nodes[nodeIndex].leftFirst;
+        int count = nodes[nodeIndex].count;
+        int last = first + count - 1;
+
+        if (count <= maxLeafSize) {
+            AABB bounds;
+            for (int i = first; i <= last; i++) bounds.expand(state.bounds[indices[i]]);
+            nodes[nodeIndex].bounds = bounds;
+            return;
+        }
+
+        // Último primitivo que compartilha com o primeiro mais bits do que o
+        // prefixo comum do intervalo; códigos iguais são divididos ao meio
+        int mid;
+        if (codes[first] == codes[last]) {
+            mid = first + count / 2;
+        } else {
+            int prefix = __builtin_clz(codes[first] ^ codes[last]);
+            int lo = first, hi = last;
+            while (hi - lo > 1) {
+                int probe = (lo + hi) / 2;
+                if (__builtin_clz(codes[first] ^ codes[probe]) > prefix) lo = probe;
+                else hi = probe;
+            }
+            mid = hi;
+        }
+
+        int left = split(state, nodeIndex, first, mid, last + 1);
+        if (count >= ParallelTaskSize) {
+            #pragma omp task shared(state, codes)
+            buildMortonNode(state, codes, left);
+            buildMortonNode(state, codes, left + 1);
+            #pragma omp taskwait
+        } else {
+            buildMortonNode(state, codes, left);
+            buildMortonNode(state, codes, left + 1);
+        }
+
+        AABB bounds = nodes[left].bounds;
+        bounds.expand(nodes[left + 1].bounds);
+        nodes[nodeIndex].bounds = bounds;
+    }
+
+    // Intercala dois zeros entre os 10 bits menos significativos de v
+    static uint32_t expandBits(uint32_t v) {
+        v = std::min(v, 1023u);
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    // Ordenação radix estável (3 passadas de 10 bits) dos códigos de 30
+    // bits, levando junto os índices. Cada bloco conta seus dígitos em
+    // paralelo; as posições de saída vêm da soma dos histogramas em ordem.
+    static void radixSort(std::vector<uint32_t>& keys, std::vector<int>& values) {
+        const int Radix = 1024;
+        int n = static_cast<int>(keys.size());
+        int chunks = chunkCount(n);
+        std::vector<uint32_t> keysOut(n);
+        std::vector<int> valuesOut(n);
+        std::vector<int> histograms(static_cast<size_t>(chunks) * Radix);
+
+        for (int shift = 0; shift < 30; shift += 10) {
+            std::fill(histograms.begin(), histograms.end(), 0);
+            #pragma omp parallel for if (chunks > 1)
+            for (int c = 0; c < chunks; c++) {
+                int* histogram = &histograms[static_cast<size_t>(c) * Radix];
+                int end = static_cast<int>(static_cast<long long>(n) * (c + 1) / chunks);
+                for (int i = static_cast<int>(static_cast<long long>(n) * c / chunks); i < end; i++) {
+                    histogram[(keys[i] >> shift) & (Radix - 1)]++;
+                }
+            }
+
+            // Posição inicial de cada dígito em cada bloco
+            int offset = 0;
+            for (int digit = 0; digit < Radix; digit++) {
+                for (int c = 0; c < chunks; c++) {
+                    int& slot = histograms[static_cast<size_t>(c) * Radix + digit];
+                    int bucket = slot;
+                    slot = offset;
+                    offset += bucket;
+                }
+            }
+
+            #pragma omp parallel for if (chunks > 1)
+            for (int c = 0; c < chunks; c++) {
+                int* position = &histograms[static_cast<size_t>(c) * Radix];
+                int end = static_cast<int>(static_cast<long long>(n) * (c + 1) / chunks);
+                for (int i = static_cast<int>(static_cast<long long>(n) * c / chunks); i < end; i++) {
+                    int target = position[(keys[i] >> shift) & (Radix - 1)]++;
+                    keysOut[target] = keys[i];
+                    valuesOut[target] = values[i];
+                }
+            }
+            keys.swap(keysOut);
+            values.swap(valuesOut);
+        }
+    }
+
+    static int binIndex(float centroid, float axisMin, float scale) {
+        int b = static_cast<int>((centroid - axisMin) * scale);
+        return std::min(std::max(b, 0), NumBins - 1);
+    }
+};
+
+#endif // BVH_H
@@ -0,0 +1,52 @@
+#ifndef BVH_NODE_H
+#define BVH_NODE_H
+
+#include "../geometry/AABB.h"
+#include "../core/RayPacket.h"
+
+// Nó da BVH em layout plano (32 bytes).
+// Nó interno: leftFirst é o índice do filho esquerdo (o direito é leftFirst + 1).
+// Folha: leftFirst é a posição do primeiro primitivo em "indices".
+struct BVHNode {
+    AABB bounds;     // Caixa delimitadora do nó
+    int leftFirst;   // Filho esquerdo ou primeiro primitivo
+    int count;       // Número de primitivos (0 para nós internos)
+
+    bool isLeaf() const { return count > 0; }
+};
+
+// Origem e inverso da direção de um raio replicados em N lanes, para testar
+// N caixas de uma vez
+template <int N>
+struct SlabRay {
+    vfloat<N> ox, oy, oz;
+    vfloat<N> ix, iy, iz;
+
+    explicit SlabRay(const Ray& ray)
+        : ox(ray.origin.x), oy(ray.origin.y), oz(ray.origin.z),
+          ix(1.0f / ray.direction.x), iy(1.0f / ray.direction.y), iz(1.0f / ray.direction.z) {}
+};
+
+// Recorta [tNear, tFar] pelo par de planos [lo, hi] de um eixo. Assim como
+// em AABB::hit, as comparações descartam NaN sem rejeitar o raio.
+template <int N>
+inline void clipSlab(const vfloat<N>& lo, const vfloat<N>& hi, const vfloat<N>& origin, const vfloat<N>& invDir,
+                     vfloat<N>& tNear, vfloat<N>& tFar) {
+    vfloat<N> t1 = (lo - origin) * invDir;
+    vfloat<N> t2 = (hi - origin) * invDir;
+    vfloat<N> tEnter = select(t1 < t2, t1, t2);
+    vfloat<N> tExit = select(t1 < t2, t2, t1);
+    tNear = select(tEnter > tNear, tEnter, tNear);
+    tFar = select(tExit < tFar, tExit, tFar);
+}
+
+// Lanes do pacote que atingem a caixa no intervalo [tMin, tMax]
+inline PacketMask hitBoxPacket(const AABB& box, const RayPacket& packet, float tMin, const PacketFloat& tMax) {
+    PacketFloat tNear(tMin), tFar = tMax;
+    clipSlab(PacketFloat(box.min.x), PacketFloat(box.max.x), packet.origin.x, packet.invDirection.x, tNear, tFar);
+    clipSlab(PacketFloat(box.min.y), PacketFloat(box.max.y), packet.origin.y, packet.invDirection.y, tNear, tFar);
+    clipSlab(PacketFloat(box.min.z), PacketFloat(box.max.z), packet.origin.z, packet.invDirection.z, tNear, tFar);
+    return tNear <= tFar;
+}
+
+#endif // BVH_NODE_H
@@ -0,0 +1,324 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "SpatialQueries.h"
+
+// Grade regular sobre as caixas dos primitivos, alternativa à BVH com a
+// mesma interface de consulta (intersect, occluded, intersectPacket,
+// occludedPacket, com as mesmas funções de teste dos primitivos).
+// A resolução vem de "density" (células por primitivo), proporcional à
+// extensão da cena em cada eixo. Cada célula lista os primitivos cujas
+// caixas a tocam, e o raio percorre as células em ordem (Amanatides e Woo),
+// parando quando a próxima começa depois da interseção mais próxima.
+// Grades uniformes sofrem com cenas de densidade desigual (muitos objetos
+// pequenos num mundo grande), por isso células com mais de maxCellItems
+// primitivos ganham uma subgrade própria, com a mesma densidade: uma grade
+// hierárquica de dois níveis. Com maxCellItems 0 a grade é uniforme.
+class Grid {
+public:
+    static const int MaxResolution = 256;   // Células por eixo em cada nível
+
+    float density;          // Células por primitivo em cada nível
+    int maxCellItems;       // Células com mais primitivos ganham subgrade (0: grade uniforme)
+
+    Grid(float density = 2.0f, int maxCellItems = 16) : density(density), maxCellItems(maxCellItems), count(0) {}
+
+    bool isBuilt() const { return !levels.empty(); }
+
+    int primitiveCount() const { return count; }
+
+    AABB bounds() const { return levels.empty() ? AABB() : levels[0].bounds; }
+
+    // Níveis construídos: 1 para a grade principal mais 1 por subgrade
+    int levelCount() const { return static_cast<int>(levels.size()); }
+
+    void clear() {
+        levels.clear();
+        cellStart.clear();
+        cellChild.clear();
+        items.clear();
+        count = 0;
+    }
+
+    // Memória das células e das listas de primitivos, em bytes
+    size_t memoryUsage() const {
+        return levels.capacity() * sizeof(Level) +
+               (cellStart.capacity() + cellChild.capacity() + items.capacity()) * sizeof(int);
+    }
+
+    // Constrói a grade a partir das caixas dos primitivos
+    void build(const std::vector<AABB>& primitiveBounds) {
+        clear();
+        int n = static_cast<int>(primitiveBounds.size());
+        if (n == 0) return;
+        count = n;
+
+        AABB box;
+        std::vector<int> all(n);
+        for (int i = 0; i < n; i++) {
+            box.expand(primitiveBounds[i]);
+            all[i] = i;
+        }
+
+        Level top = makeLevel(box, n);
+        top.firstCell = 0;
+        std::vector<int> start, list;
+        fill(top, primitiveBounds, all, start, list);
+        levels.push_back(top);
+
+        // Células da grade principal; as lotadas ficam vazias e apontam
+        // para a subgrade, cujas células vêm depois
+        int topCells = cellTotal(top);
+        cellStart.reserve(topCells + 1);
+        cellChild.assign(topCells, -1);
+        std::vector<int> crowded;
+        for (int c = 0; c < topCells; c++) {
+            cellStart.push_back(static_cast<int>(items.size()));
+            if (maxCellItems > 0 && start[c + 1] - start[c] > maxCellItems) {
+                crowded.push_back(c);
+                continue;
+            }
+            items.insert(items.end(), list.begin() + start[c], list.begin() + start[c + 1]);
+        }
+
+        for (size_t k = 0; k < crowded.size(); k++) {
+            int c = crowded[k];
+            std::vector<int> cellItems(list.begin() + start[c], list.begin() + start[c + 1]);
+
+            // A subgrade cobre a parte da célula ocupada pelos seus primitivos
+            AABB occupied;
+            for (size_t i = 0; i < cellItems.size(); i++) occupied.expand(primitiveBounds[cellItems[i]]);
+            AABB cell = cellBounds(top, c);
+            AABB subBox(Vector3(std::max(cell.min.x, occupied.min.x), std::max(cell.min.y, occupied.min.y),
+                                std::max(cell.min.z, occupied.min.z)),
+                        Vector3(std::min(cell.max.x, occupied.max.x), std::min(cell.max.y, occupied.max.y),
+                                std::min(cell.max.z, occupied.max.z)));
+            if (subBox.isEmpty()) subBox = cell;
+
+            Level sub = makeLevel(subBox, static_cast<int>(cellItems.size()));
+            sub.firstCell = static_cast<int>(cellStart.size());
+            std::vector<int> subStart, subList;
+            fill(sub, primitiveBounds, cellItems, subStart, subList);
+            int base = static_cast<int>(items.size());
+            for (int sc = 0; sc < cellTotal(sub); sc++) cellStart.push_back(base + subStart[sc]);
+            items.insert(items.end(), subList.begin(), subList.end());
+
+            cellChild[c] = static_cast<int>(levels.size());
+            levels.push_back(sub);
+        }
+        cellStart.push_back(static_cast<int>(items.size()));
+    }
+
+    // Busca a interseção mais próxima, com o contrato de BVH::intersect
+    template <typename HitFunc>
+    bool intersect(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (levels.empty()) return false;
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float tEnter = tMin, tExit = tMax;
+        if (!levels[0].bounds.clip(ray, invDir, tEnter, tExit)) return false;
+
+        Mailbox mailbox;
+        bool hitAnything = false;
+        walkCells(ray, invDir, tEnter, tExit, tMax, [&](int cell) {
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                int index = items[i];
+                if (!mailbox.seen(index) && hitPrimitive(index, tMax)) hitAnything = true;
+            }
+            return false;
+        });
+        return hitAnything;
+    }
+
+    // Consulta de oclusão, com o contrato de BVH::occluded
+    template <typename HitFunc>
+    bool occluded(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (levels.empty()) return false;
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float tEnter = tMin, tExit = tMax;
+        if (!levels[0].bounds.clip(ray, invDir, tEnter, tExit)) return false;
+
+        Mailbox mailbox;
+        return walkCells(ray, invDir, tEnter, tExit, tMax, [&](int cell) {
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                int index = items[i];
+                if (!mailbox.seen(index) && hitPrimitive(index)) return true;
+            }
+            return false;
+        });
+    }
+
+    // Pacotes: cada lane percorre a grade sozinha (ver intersectLanes)
+    template <typename HitFunc>
+    void intersectPacket(const RayPacket& packet, float tMin, PacketHit& result, HitFunc hitPrimitive) const {
+        if (levels.empty() || packet.active.none()) return;
+        intersectLanes(*this, packet, tMin, result, hitPrimitive);
+    }
+
+    template <typename HitFunc>
+    PacketMask occludedPacket(const RayPacket& packet, float tMin, const PacketFloat& tMax,
+                              HitFunc hitPrimitive) const {
+        if (levels.empty()) return PacketMask();
+        return occludedLanes(*this, packet, tMin, tMax, hitPrimitive);
+    }
+
+private:
+    // Um nível da grade: caixa, resolução e a posição das suas células em
+    // cellStart (as células de todos os níveis ficam em sequência)
+    struct Level {
+        AABB bounds;
+        int res[3];
+        Vector3 cellSize;
+        Vector3 invCellSize;
+        int firstCell;
+    };
+
+    std::vector<Level> levels;      // levels[0] é a grade principal
+    std::vector<int> cellStart;     // Primeiro item de cada célula em "items" (mais o fim da última)
+    std::vector<int> cellChild;     // Subgrade (em "levels") de cada célula da grade principal, ou -1
+    std::vector<int> items;         // Índices dos primitivos, agrupados por célula
+    int count;
+
+    // Resolução para "total" primitivos na caixa: density * total células,
+    // cúbicas o quanto possível. Eixos achatados têm uma espessura mínima
+    // no cálculo do volume e ficam com uma célula.
+    Level makeLevel(const AABB& box, int total) const {
+        Level level;
+        level.bounds = box;
+        Vector3 extent = box.extent();
+        float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        float volume = 1.0f;
+        for (int axis = 0; axis < 3; axis++) volume *= std::max(extent[axis], maxExtent * 1e-3f);
+        float cellsPerUnit = maxExtent > 0.0f ? std::cbrt(density * total / volume) : 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            // Limite aplicado ainda em float, antes da conversão para int
+            float res = std::ceil(extent[axis] * cellsPerUnit);
+            level.res[axis] = res < 1.0f ? 1 : res > MaxResolution ? int(MaxResolution) : static_cast<int>(res);
+            level.cellSize[axis] = extent[axis] / level.res[axis];
+            level.invCellSize[axis] = extent[axis] > 0.0f ? level.res[axis] / extent[axis] : 0.0f;
+        }
+        level.firstCell = 0;
+        return level;
+    }
+
+    static int cellTotal(const Level& level) { return level.res[0] * level.res[1] * level.res[2]; }
+
+    static int cellCoordinate(const Level& level, float value, int axis) {
+        int c = static_cast<int>((value - level.bounds.min[axis]) * level.invCellSize[axis]);
+        return std::max(0, std::min(level.res[axis] - 1, c));
+    }
+
+    static AABB cellBounds(const Level& level, int cell) {
+        int c[3] = {cell % level.res[0], (cell / level.res[0]) % level.res[1], cell / (level.res[0] * level.res[1])};
+        AABB box;
+        for (int axis = 0; axis < 3; axis++) {
+            box.min[axis] = level.bounds.min[axis] + c[axis] * level.cellSize[axis];
+            box.max[axis] = c[axis] + 1 == level.res[axis] ? level.bounds.max[axis]
+                                                            : box.min[axis] + level.cellSize[axis];
+        }
+        return box;
+    }
+
+    // Listas das células de um nível em CSR: os primitivos da célula c são
+    // list[start[c]] até list[start[c + 1]] (contagem, soma de prefixos e
+    // preenchimento)
+    void fill(const Level& level, const std::vector<AABB>& primitiveBounds, const std::vector<int>& primitives,
+              std::vector<int>& start, std::vector<int>& list) const {
+        int cells = cellTotal(level);
+        start.assign(cells + 1, 0);
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < primitives.size(); i++) {
+                const AABB& box = primitiveBounds[primitives[i]];
+                int lo[3], hi[3];
+                for (int axis = 0; axis < 3; axis++) {
+                    lo[axis] = cellCoordinate(level, box.min[axis], axis);
+                    hi[axis] = cellCoordinate(level, box.max[axis], axis);
+                }
+                for (int z = lo[2]; z <= hi[2]; z++) {
+                    for (int y = lo[1]; y <= hi[1]; y++) {
+                        for (int x = lo[0]; x <= hi[0]; x++) {
+                            int cell = x + level.res[0] * (y + level.res[1] * z);
+                            if (pass == 0) start[cell + 1]++;
+                            else list[start[cell]++] = primitives[i];
+                        }
+                    }
+                }
+            }
+            if (pass == 0) {
+                for (int c = 0; c < cells; c++) start[c + 1] += start[c];
+                list.resize(start[cells]);
+            } else {
+                // O preenchimento avançou cada início até o fim da célula
+                for (int c = cells; c > 0; c--) start[c] = start[c - 1];
+                start[0] = 0;
+            }
+        }
+    }
+
+    // Percorre as células da grade principal atingidas em [tEnter, tExit],
+    // descendo nas subgrades; visit(célula) retorna true para encerrar
+    template <typename Visit>
+    bool walkCells(const Ray& ray, const Vector3& invDir, float tEnter, float tExit, const float& limit,
+                   Visit visit) const {
+        return walk(levels[0], ray, invDir, tEnter, tExit, limit, [&](int cell, float cellEnter, float cellExit) {
+            int child = cellChild[cell];
+            if (child < 0) return visit(cell);
+            const Level& sub = levels[child];
+            if (!sub.bounds.clip(ray, invDir, cellEnter, cellExit)) return false;
+            return walk(sub, ray, invDir, cellEnter, cellExit, limit, [&](int subCell, float, float) {
+                return visit(subCell);
+            });
+        });
+    }
+
+    // Amanatides e Woo: visita as células do nível atravessadas pelo raio em
+    // [tEnter, tExit], da mais próxima para a mais distante, e termina quando
+    // visit(célula, entrada, saída) retorna true ou quando "limit" (a
+    // interseção mais próxima até agora) fica antes do fim da célula atual
+    template <typename Visit>
+    bool walk(const Level& level, const Ray& ray, const Vector3& invDir, float tEnter, float tExit,
+              const float& limit, Visit visit) const {
+        const float infinity = std::numeric_limits<float>::infinity();
+        Vector3 entry = ray.origin + ray.direction * tEnter;
+        int cell[3], step[3], end[3];
+        float next[3], delta[3];
+        for (int axis = 0; axis < 3; axis++) {
+            cell[axis] = cellCoordinate(level, entry[axis], axis);
+            float origin = ray.origin[axis];
+            float direction = ray.direction[axis];
+            if (direction > 0.0f) {
+                step[axis] = 1;
+                end[axis] = level.res[axis];
+                next[axis] = (level.bounds.min[axis] + (cell[axis] + 1) * level.cellSize[axis] - origin) * invDir[axis];
+                delta[axis] = level.cellSize[axis] * invDir[axis];
+            } else if (direction < 0.0f) {
+                step[axis] = -1;
+                end[axis] = -1;
+                next[axis] = (level.bounds.min[axis] + cell[axis] * level.cellSize[axis] - origin) * invDir[axis];
+                delta[axis] = -level.cellSize[axis] * invDir[axis];
+            } else {
+                step[axis] = 0;
+                end[axis] = -1;
+                next[axis] = infinity;
+                delta[axis] = infinity;
+            }
+        }
+
+        while (true) {
+            int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+            float cellExit = std::min(next[axis], tExit);
+            int index = level.firstCell + cell[0] + level.res[0] * (cell[1] + level.res[1] * cell[2]);
+            if (visit(index, tEnter, cellExit)) return true;
+            if (cellExit >= tExit || limit <= cellExit) return false;
+            cell[axis] += step[axis];
+            if (cell[axis] == end[axis]) return false;
+            tEnter = cellExit;
+            next[axis] += delta[axis];
+        }
+    }
+};
+
+#endif // GRID_H
@@ -0,0 +1,308 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "SpatialQueries.h"
+
+// Nó da árvore kd em 8 bytes. Os 2 bits baixos de "flags" guardam o eixo
+// do plano (0 a 2) ou 3 nas folhas; os demais, o índice do filho de cima
+// do plano (o de baixo é sempre o nó seguinte) ou o número de primitivos
+// da folha, que começam em items[firstItem].
+struct KdNode {
+    union {
+        float split;    // Posição do plano no eixo (nó interno)
+        int firstItem;  // Primeiro primitivo em "items" (folha)
+    };
+    uint32_t flags;
+
+    bool isLeaf() const { return (flags & 3u) == 3u; }
+    int axis() const { return static_cast<int>(flags & 3u); }
+    int aboveChild() const { return static_cast<int>(flags >> 2); }
+    int itemCount() const { return static_cast<int>(flags >> 2); }
+};
+
+// Árvore kd construída com a SAH, alternativa à BVH com a mesma interface
+// de consulta. Os planos dividem o espaço (não os primitivos): um primitivo
+// que cruza o plano vai para os dois lados, e o raio visita as folhas em
+// ordem ao longo do seu comprimento, parando na primeira que começa depois
+// da interseção mais próxima. O custo de cada plano é avaliado em bins,
+// como na BVH, com um bônus para planos que isolam espaço vazio; a
+// profundidade é limitada a 8 + 1,3 log2(n).
+class KdTree {
+public:
+    static const int NumBins = 32;      // Planos candidatos por eixo
+    static const int StackSize = 64;    // Pilha de travessia (maior que a profundidade máxima)
+
+    float intersectionCost;     // Custo de testar um primitivo, em passos de travessia
+    float emptyBonus;           // Redução do custo de planos com um lado vazio
+    int maxLeafSize;            // Nós com até esse número de primitivos viram folhas
+
+    KdTree(float intersectionCost = 4.0f, float emptyBonus = 0.5f, int maxLeafSize = 1)
+        : intersectionCost(intersectionCost), emptyBonus(emptyBonus), maxLeafSize(maxLeafSize), count(0) {}
+
+    bool isBuilt() const { return !nodes.empty(); }
+
+    int primitiveCount() const { return count; }
+
+    AABB bounds() const { return box; }
+
+    int nodeCount() const { return static_cast<int>(nodes.size()); }
+
+    void clear() {
+        nodes.clear();
+        items.clear();
+        box = AABB();
+        count = 0;
+    }
+
+    // Memória dos nós e das listas das folhas, em bytes
+    size_t memoryUsage() const {
+        return nodes.capacity() * sizeof(KdNode) + items.capacity() * sizeof(int);
+    }
+
+    // Constrói a árvore a partir das caixas dos primitivos
+    void build(const std::vector<AABB>& primitiveBounds) {
+        clear();
+        int n = static_cast<int>(primitiveBounds.size());
+        if (n == 0) return;
+        count = n;
+
+        std::vector<int> primitives(n);
+        for (int i = 0; i < n; i++) {
+            box.expand(primitiveBounds[i]);
+            primitives[i] = i;
+        }
+        int maxDepth = static_cast<int>(8.0f + 1.3f * std::log2(static_cast<float>(n)));
+        maxDepth = std::min(maxDepth, StackSize - 1);
+        buildNode(primitiveBounds, box, primitives, maxDepth, 0);
+        nodes.shrink_to_fit();
+        items.shrink_to_fit();
+    }
+
+    // Busca a interseção mais próxima, com o contrato de BVH::intersect
+    template <typename HitFunc>
+    bool intersect(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float tEnter = tMin, tExit = tMax;
+        if (!box.clip(ray, invDir, tEnter, tExit)) return false;
+
+        struct StackEntry { int node; float tEnter, tExit; };
+        StackEntry stack[StackSize];
+        int stackPtr = 0;
+        int current = 0;
+        Mailbox mailbox;
+        bool hitAnything = false;
+
+        while (true) {
+            // A interseção mais próxima fica antes deste nó: nada mais a visitar
+            if (tMax < tEnter) break;
+            const KdNode& node = nodes[current];
+
+            if (!node.isLeaf()) {
+                int second;
+                float tPlane;
+                if (descend(ray, invDir, current, tEnter, tExit, second, tPlane)) {
+                    stack[stackPtr++] = StackEntry{second, tPlane, tExit};
+                    tExit = tPlane;
+                }
+                continue;
+            }
+
+            for (int i = 0; i < node.itemCount(); i++) {
+                int index = items[node.firstItem + i];
+                if (!mailbox.seen(index) && hitPrimitive(index, tMax)) hitAnything = true;
+            }
+            if (stackPtr == 0) break;
+            const StackEntry& entry = stack[--stackPtr];
+            current = entry.node;
+            tEnter = entry.tEnter;
+            tExit = entry.tExit;
+        }
+
+        return hitAnything;
+    }
+
+    // Consulta de oclusão, com o contrato de BVH::occluded
+    template <typename HitFunc>
+    bool occluded(const Ray& ray, float tMin, float tMax, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+        Vector3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+        float tEnter = tMin, tExit = tMax;
+        if (!box.clip(ray, invDir, tEnter, tExit)) return false;
+
+        struct StackEntry { int node; float tEnter, tExit; };
+        StackEntry stack[StackSize];
+        int stackPtr = 0;
+        int current = 0;
+        Mailbox mailbox;
+
+        while (true) {
+            const KdNode& node = nodes[current];
+
+            if (!node.isLeaf()) {
+                int second;
+                float tPlane;
+                if (descend(ray, invDir, current, tEnter, tExit, second, tPlane)) {
+                    stack[stackPtr++] = StackEntry{second, tPlane, tExit};
+                    tExit = tPlane;
+                }
+                continue;
+            }
+
+            for (int i = 0; i < node.itemCount(); i++) {
+                int index = items[node.firstItem + i];
+                if (!mailbox.seen(index) && hitPrimitive(index)) return true;
+            }
+            if (stackPtr == 0) break;
+            const StackEntry& entry = stack[--stackPtr];
+            current = entry.node;
+            tEnter = entry.tEnter;
+            tExit = entry.tExit;
+        }
+
+        return false;
+    }
+
+    // Pacotes: cada lane percorre a árvore sozinha (ver intersectLanes)
+    template <typename HitFunc>
+    void intersectPacket(const RayPacket& packet, float tMin, PacketHit& result, HitFunc hitPrimitive) const {
+        if (nodes.empty() || packet.active.none()) return;
+        intersectLanes(*this, packet, tMin, result, hitPrimitive);
+    }
+
+    template <typename HitFunc>
+    PacketMask occludedPacket(const RayPacket& packet, float tMin, const PacketFloat& tMax,
+                              HitFunc hitPrimitive) const {
+        if (nodes.empty()) return PacketMask();
+        return occludedLanes(*this, packet, tMin, tMax, hitPrimitive);
+    }
+
+private:
+    std::vector<KdNode> nodes;      // Nós em pré-ordem (raiz em nodes[0])
+    std::vector<int> items;         // Primitivos das folhas (com repetições)
+    AABB box;                       // Caixa da árvore
+    int count;
+
+    // Passo da travessia num nó interno com o trecho [tEnter, tExit] do
+    // raio: "current" passa ao filho do lado da origem. Se o raio também
+    // cruza o plano dentro do trecho, retorna true com o outro filho em
+    // "second" e a distância do plano em tPlane: o primeiro filho fica com
+    // [tEnter, tPlane] e o segundo com [tPlane, tExit].
+    bool descend(const Ray& ray, const Vector3& invDir, int& current, float tEnter, float tExit,
+                 int& second, float& tPlane) const {
+        const KdNode& node = nodes[current];
+        int axis = node.axis();
+        float origin = ray.origin[axis];
+        float direction = ray.direction[axis];
+        bool belowFirst = origin < node.split || (origin == node.split && direction <= 0.0f);
+        int first = belowFirst ? current + 1 : node.aboveChild();
+        second = belowFirst ? node.aboveChild() : current + 1;
+
+        tPlane = direction != 0.0f ? (node.split - origin) * invDir[axis] : std::numeric_limits<float>::infinity();
+        if (tPlane > tExit || tPlane <= 0.0f) {
+            current = first;
+            return false;
+        }
+        if (tPlane < tEnter) {
+            current = second;
+            return false;
+        }
+        current = first;
+        return true;
+    }
+
+    // Constrói o nó (e a subárvore) de "primitives" na caixa "bounds", em
+    // pré-ordem: o filho de baixo é construído logo depois do nó
+    void buildNode(const std::vector<AABB>& primitiveBounds, const AABB& bounds, std::vector<int>& primitives,
+                   int depth, int badRefines) {
+        int nodeIndex = static_cast<int>(nodes.size());
+        nodes.push_back(KdNode());
+        int total = static_cast<int>(primitives.size());
+        if (total <= maxLeafSize || depth == 0) {
+            makeLeaf(nodeIndex, primitives);
+            return;
+        }
+
+        // Cada primitivo (recortado à caixa do nó) conta no bin onde começa
+        // e no bin onde termina; abaixo do plano b ficam os que começam
+        // antes dele, acima os que terminam depois
+        Vector3 extent = bounds.extent();
+        float invArea = 1.0f / bounds.surfaceArea();
+        float bestCost = std::numeric_limits<float>::infinity();
+        int bestAxis = -1;
+        float bestSplit = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            if (extent[axis] <= 0.0f) continue;
+            int starts[NumBins] = {0};
+            int ends[NumBins] = {0};
+            float scale = NumBins / extent[axis];
+            for (int i = 0; i < total; i++) {
+                const AABB& primitive = primitiveBounds[primitives[i]];
+                starts[binIndex(primitive.min[axis], bounds.min[axis], scale)]++;
+                ends[binIndex(primitive.max[axis], bounds.min[axis], scale)]++;
+            }
+
+            int below = 0, above = total;
+            for (int b = 1; b < NumBins; b++) {
+                below += starts[b - 1];
+                above -= ends[b - 1];
+                float split = bounds.min[axis] + extent[axis] * b / NumBins;
+                AABB belowBox = bounds, aboveBox = bounds;
+                belowBox.max[axis] = split;
+                aboveBox.min[axis] = split;
+                float bonus = below == 0 || above == 0 ? emptyBonus : 0.0f;
+                float cost = 1.0f + (1.0f - bonus) * intersectionCost *
+                             (belowBox.surfaceArea() * invArea * below + aboveBox.surfaceArea() * invArea * above);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        // Divisões piores que a folha são toleradas algumas vezes seguidas,
+        // porque as seguintes podem compensar
+        float leafCost = intersectionCost * total;
+        if (bestCost > leafCost) badRefines++;
+        if (bestAxis < 0 || (bestCost > 4.0f * leafCost && total < 16) || badRefines == 3) {
+            makeLeaf(nodeIndex, primitives);
+            return;
+        }
+
+        std::vector<int> below, above;
+        for (int i = 0; i < total; i++) {
+            const AABB& primitive = primitiveBounds[primitives[i]];
+            bool isAbove = primitive.max[bestAxis] > bestSplit;
+            if (primitive.min[bestAxis] < bestSplit || !isAbove) below.push_back(primitives[i]);
+            if (isAbove) above.push_back(primitives[i]);
+        }
+        std::vector<int>().swap(primitives);    // Libera a lista antes de descer
+
+        AABB belowBounds = bounds, aboveBounds = bounds;
+        belowBounds.max[bestAxis] = bestSplit;
+        aboveBounds.min[bestAxis] = bestSplit;
+        buildNode(primitiveBounds, belowBounds, below, depth - 1, badRefines);
+        nodes[nodeIndex].split = bestSplit;
+        nodes[nodeIndex].flags = static_cast<uint32_t>(bestAxis) | (static_cast<uint32_t>(nodes.size()) << 2);
+        buildNode(primitiveBounds, aboveBounds, above, depth - 1, badRefines);
+    }
+
+    void makeLeaf(int nodeIndex, const std::vector<int>& primitives) {
+        nodes[nodeIndex].firstItem = static_cast<int>(items.size());
+        nodes[nodeIndex].flags = 3u | (static_cast<uint32_t>(primitives.size()) << 2);
+        items.insert(items.end(), primitives.begin(), primitives.end());
+    }
+
+    static int binIndex(float value, float axisMin, float scale) {
+        int b = static_cast<int>((value - axisMin) * scale);
+        return std::min(std::max(b, 0), NumBins - 1);
+    }
+};
+
+#endif // KD_TREE_H
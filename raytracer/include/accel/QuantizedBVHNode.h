@@ -0,0 +1,129 @@
+#ifndef QUANTIZED_BVH_NODE_H
+#define QUANTIZED_BVH_NODE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "BVHNode.h"
+
+// Nó comprimido de uma BVH de 4 filhos, em exatamente 64 bytes (uma linha
+// de cache), contra 112 bytes do WideBVHNode<4> e 256 do WideBVHNode<8>.
+// As caixas dos filhos são guardadas com 8 bits por coordenada, relativas
+// à caixa do nó: coordenada = origin + q * 2^exponent. A escala é uma
+// potência de 2, então q * escala é exato e a caixa decodificada é sempre
+// a mesma; a quantização arredonda para fora, de modo que ela contém a
+// caixa original (a travessia só visita alguns nós a mais).
+// Cada filho é uma palavra de 32 bits: o índice do nó interno, ou, com o
+// bit mais alto ligado, uma referência compacta de folha com o número de
+// primitivos (4 bits) e a posição do primeiro em "indices" (27 bits).
+struct QuantizedBVHNode {
+    static const int Width = 4;
+    static const int MaxLeafCount = 16;                 // Primitivos por folha
+    static const uint32_t MaxPrimitives = 1u << 27;     // Posições em "indices"
+
+    float origin[3];                // Canto mínimo da caixa do nó
+    signed char exponent[3];        // Escala de cada eixo: 2^exponent
+    unsigned char childCount;       // Filhos válidos (os primeiros childCount lugares)
+    unsigned char qMinX[4], qMaxX[4];
+    unsigned char qMinY[4], qMaxY[4];
+    unsigned char qMinZ[4], qMaxZ[4];
+    uint32_t child[4];              // Nó interno ou referência de folha
+    unsigned char padding[8];
+
+    // Quantiza as caixas dos "total" primeiros filhos em relação à caixa que
+    // envolve todas elas
+    void setBounds(const AABB* bounds, int total) {
+        AABB box;
+        for (int c = 0; c < total; c++) box.expand(bounds[c]);
+        childCount = static_cast<unsigned char>(total);
+        std::memset(padding, 0, sizeof(padding));
+
+        unsigned char* qMin[3] = {qMinX, qMinY, qMinZ};
+        unsigned char* qMax[3] = {qMaxX, qMaxY, qMaxZ};
+        for (int axis = 0; axis < 3; axis++) {
+            origin[axis] = box.min[axis];
+
+            // Menor escala em que 255 passos cobrem a caixa do nó
+            float extent = box.max[axis] - box.min[axis];
+            int e = extent > 0.0f ? static_cast<int>(std::ceil(std::log2(extent / 255.0f))) : -126;
+            e = std::max(-126, std::min(127, e));
+            while (e < 127 && decode(axis, 255, powerOfTwo(e)) < box.max[axis]) e++;
+            exponent[axis] = static_cast<signed char>(e);
+            float scale = powerOfTwo(e);
+
+            for (int c = 0; c < 4; c++) {
+                if (c >= total) {
+                    qMin[axis][c] = 0;
+                    qMax[axis][c] = 0;
+                    continue;
+                }
+                float lo = (bounds[c].min[axis] - origin[axis]) / scale;
+                float hi = (bounds[c].max[axis] - origin[axis]) / scale;
+                int q0 = static_cast<int>(std::max(0.0f, std::min(255.0f, std::floor(lo))));
+                int q1 = static_cast<int>(std::max(0.0f, std::min(255.0f, std::ceil(hi))));
+                // Corrige o arredondamento da divisão para nunca encolher a caixa
+                while (q0 > 0 && decode(axis, q0, scale) > bounds[c].min[axis]) q0--;
+                while (q1 < 255 && decode(axis, q1, scale) < bounds[c].max[axis]) q1++;
+                qMin[axis][c] = static_cast<unsigned char>(q0);
+                qMax[axis][c] = static_cast<unsigned char>(q1);
+            }
+        }
+        for (int c = 0; c < 4; c++) child[c] = 0;
+    }
+
+    // Filho interno (primitiveCount 0) ou folha; false se a folha não cabe
+    // na referência compacta
+    bool setChild(int slot, int index, int primitiveCount) {
+        if (primitiveCount == 0) {
+            child[slot] = static_cast<uint32_t>(index);
+            return true;
+        }
+        if (primitiveCount > MaxLeafCount || static_cast<uint32_t>(index) >= MaxPrimitives) return false;
+        child[slot] = 0x80000000u | (static_cast<uint32_t>(primitiveCount - 1) << 27) | static_cast<uint32_t>(index);
+        return true;
+    }
+
+    int childIndex(int slot) const {
+        return static_cast<int>(child[slot] >> 31 ? child[slot] & (MaxPrimitives - 1) : child[slot]);
+    }
+    int leafCount(int slot) const { return child[slot] >> 31 ? static_cast<int>((child[slot] >> 27) & 0xfu) + 1 : 0; }
+
+    AABB childBounds(int slot) const {
+        return AABB(Vector3(decode(0, qMinX[slot], scale(0)), decode(1, qMinY[slot], scale(1)), decode(2, qMinZ[slot], scale(2))),
+                    Vector3(decode(0, qMaxX[slot], scale(0)), decode(1, qMaxY[slot], scale(1)), decode(2, qMaxZ[slot], scale(2))));
+    }
+
+    // Mesmo teste de WideBVHNode::intersect, sobre as caixas decodificadas
+    unsigned int intersect(const SlabRay<4>& ray, float tMin, float tMax, float* distances) const {
+        vfloat<4> tNear(tMin), tFar(tMax);
+        clipSlab(decode(0, qMinX), decode(0, qMaxX), ray.ox, ray.ix, tNear, tFar);
+        clipSlab(decode(1, qMinY), decode(1, qMaxY), ray.oy, ray.iy, tNear, tFar);
+        clipSlab(decode(2, qMinZ), decode(2, qMaxZ), ray.oz, ray.iz, tNear, tFar);
+        tNear.store(distances);
+        return (tNear <= tFar).bits() & ((1u << childCount) - 1u);
+    }
+
+private:
+    // 2^e para e em [-126, 127], montado direto no expoente do float
+    static float powerOfTwo(int e) {
+        uint32_t bits = static_cast<uint32_t>(e + 127) << 23;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    float scale(int axis) const { return powerOfTwo(exponent[axis]); }
+
+    float decode(int axis, int q, float scale) const {
+        return origin[axis] + static_cast<float>(q) * scale;
+    }
+
+    // Coordenadas dos 4 filhos num eixo
+    vfloat<4> decode(int axis, const unsigned char* q) const {
+        return vfloat<4>(origin[axis]) + vfloat<4>::loadBytes(q) * vfloat<4>(scale(axis));
+    }
+};
+
+static_assert(sizeof(QuantizedBVHNode) == 64, "QuantizedBVHNode deve ocupar uma linha de cache");
+
+#endif // QUANTIZED_BVH_NODE_H
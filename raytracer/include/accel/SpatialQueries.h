@@ -0,0 +1,70 @@
+#ifndef SPATIAL_QUERIES_H
+#define SPATIAL_QUERIES_H
+
+#include "../geometry/AABB.h"
+#include "../core/RayPacket.h"
+
+// Peças comuns às estruturas que subdividem o espaço (Grid, KdTree), em que
+// um primitivo aparece em várias células e é encontrado mais de uma vez
+// pelo mesmo raio.
+
+// Caixa postal de um raio: lembra os últimos primitivos testados (um por
+// posição, pelos bits baixos do índice) para não testá-los de novo. Repetir
+// o teste não muda o resultado: com tMax igual ou menor, um primitivo que
+// errou continua errando e um que acertou não melhora a interseção.
+struct Mailbox {
+    static const int Size = 16;
+    int recent[Size];
+
+    Mailbox() {
+        for (int i = 0; i < Size; i++) recent[i] = -1;
+    }
+
+    // true se o primitivo já foi testado por este raio; senão o registra
+    bool seen(int index) {
+        int& slot = recent[index & (Size - 1)];
+        if (slot == index) return true;
+        slot = index;
+        return false;
+    }
+};
+
+// intersectPacket para estruturas sem travessia de pacotes: cada lane ativa
+// percorre a estrutura sozinha (intersect), e hitPrimitive recebe a máscara
+// de uma única lane. Mesmo contrato de BVH::intersectPacket.
+template <typename Accelerator, typename HitFunc>
+void intersectLanes(const Accelerator& accelerator, const RayPacket& packet, float tMin, PacketHit& result,
+                    HitFunc hitPrimitive) {
+    for (unsigned int bits = packet.active.bits(); bits; bits &= bits - 1) {
+        int lane = lowestLane(bits);
+        PacketMask mask = PacketMask::fromBits(1u << lane);
+        accelerator.intersect(packet.ray(lane), tMin, result.t[lane], [&](int index, float& tMax) {
+            hitPrimitive(index, mask);
+            float t = result.t[lane];
+            if (t < tMax) {
+                tMax = t;
+                return true;
+            }
+            return false;
+        });
+    }
+}
+
+// occludedPacket lane a lane, com o contrato de BVH::occludedPacket
+template <typename Accelerator, typename HitFunc>
+PacketMask occludedLanes(const Accelerator& accelerator, const RayPacket& packet, float tMin,
+                         const PacketFloat& tMax, HitFunc hitPrimitive) {
+    PacketMask blocked;
+    for (unsigned int bits = packet.active.bits(); bits; bits &= bits - 1) {
+        int lane = lowestLane(bits);
+        PacketMask mask = PacketMask::fromBits(1u << lane);
+        if (accelerator.occluded(packet.ray(lane), tMin, tMax[lane], [&](int index) {
+                return (hitPrimitive(index, mask) & mask).any();
+            })) {
+            blocked = blocked | mask;
+        }
+    }
+    return blocked;
+}
+
+#endif // SPATIAL_QUERIES_H
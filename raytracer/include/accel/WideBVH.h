@@ -0,0 +1,348 @@
+#ifndef WIDE_BVH_H
+#define WIDE_BVH_H
+
+#include <vector>
+#include <limits>
+#include "BVHNode.h"
+#include "../core/AlignedArray.h"
+
+// Largura da BVH larga: 8 filhos por nó com AVX (uma comparação de 8 lanes),
+// 4 com SSE
+static const int BVHWidth = SimdWidth >= 8 ? 8 : 4;
+
+// Nó de uma BVH com até N filhos, com as caixas dos filhos em SoA: um único
+// teste de slabs em vfloat<N> testa todos os filhos de uma vez.
+// Filho interno: child é o índice do nó e count é 0.
+// Folha: child é a posição do primeiro primitivo em "indices" e count > 0.
+// Outros formatos de nó (QuantizedBVHNode) oferecem as mesmas funções.
+template <int N>
+struct WideBVHNode {
+    static const int Width = N;
+
+    float minX[N], maxX[N];
+    float minY[N], maxY[N];
+    float minZ[N], maxZ[N];
+    int child[N];
+    int count[N];
+    int childCount;     // Filhos válidos (os primeiros childCount lugares)
+
+    // Define as caixas dos "total" primeiros filhos; os demais lugares
+    // ficam com caixas vazias
+    void setBounds(const AABB* bounds, int total) {
+        childCount = total;
+        for (int c = 0; c < N; c++) {
+            AABB box = c < total ? bounds[c] : AABB();
+            minX[c] = box.min.x; maxX[c] = box.max.x;
+            minY[c] = box.min.y; maxY[c] = box.max.y;
+            minZ[c] = box.min.z; maxZ[c] = box.max.z;
+            child[c] = 0;
+            count[c] = 0;
+        }
+    }
+
+    // Atualiza a caixa de um filho (refit)
+    void setChildBounds(int slot, const AABB& box) {
+        minX[slot] = box.min.x; maxX[slot] = box.max.x;
+        minY[slot] = box.min.y; maxY[slot] = box.max.y;
+        minZ[slot] = box.min.z; maxZ[slot] = box.max.z;
+    }
+
+    // Filho interno (primitiveCount 0) ou folha com primitiveCount primitivos
+    bool setChild(int slot, int index, int primitiveCount) {
+        child[slot] = index;
+        count[slot] = primitiveCount;
+        return true;
+    }
+
+    int childIndex(int slot) const { return child[slot]; }
+    int leafCount(int slot) const { return count[slot]; }
+
+    AABB childBounds(int slot) const {
+        return AABB(Vector3(minX[slot], minY[slot], minZ[slot]), Vector3(maxX[slot], maxY[slot], maxZ[slot]));
+    }
+
+    // Teste de slabs de um raio contra os N filhos de uma vez. Retorna os
+    // bits dos filhos atingidos em [tMin, tMax] e as distâncias de entrada.
+    unsigned int intersect(const SlabRay<N>& ray, float tMin, float tMax, float* distances) const {
+        vfloat<N> tNear(tMin), tFar(tMax);
+        clipSlab(vfloat<N>::load(minX), vfloat<N>::load(maxX), ray.ox, ray.ix, tNear, tFar);
+        clipSlab(vfloat<N>::load(minY), vfloat<N>::load(maxY), ray.oy, ray.iy, tNear, tFar);
+        clipSlab(vfloat<N>::load(minZ), vfloat<N>::load(maxZ), ray.oz, ray.iz, tNear, tFar);
+        tNear.store(distances);
+        return (tNear <= tFar).bits() & ((1u << childCount) - 1u);
+    }
+};
+
+// BVH larga obtida ao "achatar" uma BVH binária: cada nó absorve os níveis
+// de baixo até ter N filhos, abrindo sempre o filho interno de maior área.
+// As folhas continuam as mesmas da BVH binária, então os intervalos de
+// primitivos ("indices") são compartilhados com ela. Menos nós visitados por
+// raio e caixas dos irmãos lidas juntas, com os nós alinhados à linha de cache.
+// "Node" define o formato do nó: WideBVHNode<N> (floats) ou QuantizedBVHNode.
+template <typename Node>
+class WideBVH {
+public:
+    static const int N = Node::Width;
+    static const int StackSize = 64 * N;    // Pilha de travessia (até N - 1 entradas por nível)
+
+    AlignedArray<Node> nodes;       // Nós em layout plano (raiz em nodes[0])
+
+    bool empty() const { return nodes.empty(); }
+
+    void clear() { nodes.clear(); }
+
+    // Memória ocupada pelos nós, em bytes
+    size_t byteSize() const { return nodes.byteSize(); }
+
+    // Achata a BVH binária "binary". Retorna false (e fica vazia) se alguma
+    // folha não couber no formato do nó. Se "slots" não for nulo, recebe o
+    // lugar (nó * N + filho) de cada nó binário, ou -1 para os absorvidos.
+    bool build(const std::vector<BVHNode>& binary, std::vector<int>* slots = nullptr) {
+        nodes.clear();
+        if (binary.empty()) return true;
+        if (slots) slots->assign(binary.size(), -1);
+        std::vector<Node> built;
+        built.reserve(binary.size() / (N - 1) + 1);
+
+        struct Pending { int wide; int binary; };
+        std::vector<Pending> pending;
+        built.push_back(Node());
+        pending.push_back(Pending{0, 0});
+
+        while (!pending.empty()) {
+            Pending current = pending.back();
+            pending.pop_back();
+
+            int children[N];
+            int childCount = 0;
+            const BVHNode& root = binary[current.binary];
+            if (root.isLeaf()) {
+                children[childCount++] = current.binary;
+            } else {
+                children[childCount++] = root.leftFirst;
+                children[childCount++] = root.leftFirst + 1;
+            }
+
+            // Abrir o filho interno de maior área até preencher os N lugares
+            while (childCount < N) {
+                int best = -1;
+                float bestArea = -1.0f;
+                for (int c = 0; c < childCount; c++) {
+                    const BVHNode& node = binary[children[c]];
+                    if (!node.isLeaf() && node.bounds.surfaceArea() > bestArea) {
+                        best = c;
+                        bestArea = node.bounds.surfaceArea();
+                    }
+                }
+                if (best < 0) break;
+                int opened = binary[children[best]].leftFirst;
+                children[best] = opened;
+                children[childCount++] = opened + 1;
+            }
+
+            AABB bounds[N];
+            for (int c = 0; c < childCount; c++) bounds[c] = binary[children[c]].bounds;
+            Node node;
+            node.setBounds(bounds, childCount);
+            for (int c = 0; c < childCount; c++) {
+                const BVHNode& child = binary[children[c]];
+                if (slots) (*slots)[children[c]] = current.wide * N + c;
+                bool stored;
+                if (child.isLeaf()) {
+                    stored = node.setChild(c, child.leftFirst, child.count);
+                } else {
+                    int index = static_cast<int>(built.size());
+                    stored = node.setChild(c, index, 0);
+                    built.push_back(Node());
+                    pending.push_back(Pending{index, children[c]});
+                }
+                if (!stored) return false;
+            }
+            built[current.wide] = node;
+        }
+
+        nodes.resize(built.size());
+        for (size_t i = 0; i < built.size(); i++) nodes[i] = built[i];
+        return true;
+    }
+
+    // Atualiza a caixa do lugar "slot" (nó * N + filho) obtido em build
+    void setChildBounds(int slot, const AABB& box) {
+        nodes[slot / N].setChildBounds(slot % N, box);
+    }
+
+    // Mesmo contrato de BVH::intersect. Os filhos atingidos são empilhados
+    // do mais distante para o mais próximo, e entradas que começam depois da
+    // interseção atual são descartadas ao desempilhar.
+    template <typename HitFunc>
+    bool intersect(const Ray& ray, float tMin, float tMax, const int* indices, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+
+        SlabRay<N> slabRay(ray);
+        StackEntry stack[StackSize];
+        int stackPtr = 0;
+        stack[stackPtr++] = StackEntry{0, 0, tMin};
+        bool hitAnything = false;
+        float distances[N];
+
+        while (stackPtr > 0) {
+            StackEntry entry = stack[--stackPtr];
+            if (entry.tEntry > tMax) continue;
+
+            if (entry.count > 0) {
+                for (int i = 0; i < entry.count; i++) {
+                    if (hitPrimitive(indices[entry.node + i], tMax)) {
+                        hitAnything = true;
+                    }
+                }
+                continue;
+            }
+
+            const Node& node = nodes[entry.node];
+            unsigned int mask = node.intersect(slabRay, tMin, tMax, distances);
+            int first = stackPtr;
+            while (mask) {
+                int c = lowestLane(mask);
+                mask &= mask - 1;
+                // Inserção ordenada: a entrada mais próxima fica no topo
+                StackEntry child = {node.childIndex(c), node.leafCount(c), distances[c]};
+                int j = stackPtr++;
+                while (j > first && stack[j - 1].tEntry < child.tEntry) {
+                    stack[j] = stack[j - 1];
+                    j--;
+                }
+                stack[j] = child;
+            }
+        }
+
+        return hitAnything;
+    }
+
+    // Mesmo contrato de BVH::occluded
+    template <typename HitFunc>
+    bool occluded(const Ray& ray, float tMin, float tMax, const int* indices, HitFunc hitPrimitive) const {
+        if (nodes.empty()) return false;
+
+        SlabRay<N> slabRay(ray);
+        StackEntry stack[StackSize];
+        int stackPtr = 0;
+        stack[stackPtr++] = StackEntry{0, 0, tMin};
+        float distances[N];
+
+        while (stackPtr > 0) {
+            StackEntry entry = stack[--stackPtr];
+            if (entry.count > 0) {
+                for (int i = 0; i < entry.count; i++) {
+                    if (hitPrimitive(indices[entry.node + i])) return true;
+                }
+                continue;
+            }
+
+            const Node& node = nodes[entry.node];
+            unsigned int mask = node.intersect(slabRay, tMin, tMax, distances);
+            while (mask) {
+                int c = lowestLane(mask);
+                mask &= mask - 1;
+                stack[stackPtr++] = StackEntry{node.childIndex(c), node.leafCount(c), distances[c]};
+            }
+        }
+
+        return false;
+    }
+
+    // Mesmo contrato de BVH::intersectPacket. A caixa de um filho é testada
+    // contra o pacote ao desempilhar (com o result.t mais recente), e os
+    // filhos são empilhados na ordem de distância do primeiro raio ativo.
+    template <typename HitFunc>
+    void intersectPacket(const RayPacket& packet, float tMin, PacketHit& result, const int* indices,
+                         HitFunc hitPrimitive) const {
+        if (nodes.empty() || packet.active.none()) return;
+
+        SlabRay<N> lead(packet.ray(lowestLane(packet.active.bits())));
+        const float infinity = std::numeric_limits<float>::infinity();
+        PacketEntry stack[StackSize];
+        int stackPtr = 0;
+        float distances[N];
+        int order[N];
+        pushOrdered(nodes[0], 0, lead, tMin, infinity, distances, order, stack, stackPtr);
+
+        while (stackPtr > 0) {
+            PacketEntry entry = stack[--stackPtr];
+            const Node& parent = nodes[entry.parent];
+            PacketMask mask = packet.active & hitBoxPacket(parent.childBounds(entry.slot), packet, tMin, result.t);
+            if (mask.none()) continue;
+
+            int child = parent.childIndex(entry.slot);
+            int count = parent.leafCount(entry.slot);
+            if (count > 0) {
+                for (int i = 0; i < count; i++) {
+                    hitPrimitive(indices[child + i], mask);
+                }
+            } else {
+                pushOrdered(nodes[child], child, lead, tMin, infinity, distances, order, stack, stackPtr);
+            }
+        }
+    }
+
+    // Mesmo contrato de BVH::occludedPacket
+    template <typename HitFunc>
+    PacketMask occludedPacket(const RayPacket& packet, float tMin, const PacketFloat& tMax, const int* indices,
+                              HitFunc hitPrimitive) const {
+        PacketMask blocked;
+        if (nodes.empty()) return blocked;
+
+        PacketEntry stack[StackSize];
+        int stackPtr = 0;
+        for (int c = nodes[0].childCount - 1; c >= 0; c--) stack[stackPtr++] = PacketEntry{0, c};
+
+        while (stackPtr > 0) {
+            PacketMask pending = packet.active & !blocked;
+            if (pending.none()) break;
+
+            PacketEntry entry = stack[--stackPtr];
+            const Node& parent = nodes[entry.parent];
+            PacketMask mask = pending & hitBoxPacket(parent.childBounds(entry.slot), packet, tMin, tMax);
+            if (mask.none()) continue;
+
+            int child = parent.childIndex(entry.slot);
+            int count = parent.leafCount(entry.slot);
+            if (count > 0) {
+                for (int i = 0; i < count && mask.any(); i++) {
+                    blocked = blocked | hitPrimitive(indices[child + i], mask);
+                    mask = mask & !blocked;
+                }
+            } else {
+                for (int c = nodes[child].childCount - 1; c >= 0; c--) stack[stackPtr++] = PacketEntry{child, c};
+            }
+        }
+
+        return blocked;
+    }
+
+private:
+    // Nó interno (count 0) ou intervalo de uma folha, com a distância de entrada
+    struct StackEntry { int node; int count; float tEntry; };
+
+    // Filho "slot" do nó "parent" (travessia de pacotes)
+    struct PacketEntry { int parent; int slot; };
+
+    // Empilha os filhos de "node" do mais distante para o mais próximo do
+    // raio "lead"; filhos que ele não atinge vão para o fundo
+    static void pushOrdered(const Node& node, int nodeIndex, const SlabRay<N>& lead, float tMin, float tMax,
+                            float* distances, int* order, PacketEntry* stack, int& stackPtr) {
+        unsigned int mask = node.intersect(lead, tMin, tMax, distances);
+        int count = 0;
+        for (int c = 0; c < node.childCount; c++) {
+            if (!((mask >> c) & 1u)) distances[c] = std::numeric_limits<float>::infinity();
+            int j = count++;
+            while (j > 0 && distances[order[j - 1]] < distances[c]) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = c;
+        }
+        for (int i = 0; i < count; i++) stack[stackPtr++] = PacketEntry{nodeIndex, order[i]};
+    }
+};
+
+#endif // WIDE_BVH_H
@@ -0,0 +1,120 @@
+#ifndef AFFINE_MATRIX_H
+#define AFFINE_MATRIX_H
+
+#include <cmath>
+#include "Vector3.h"
+#include "Vec3x.h"
+
+// Transformação afim p' = A p + t em forma de matriz 3x4: as três linhas da
+// parte linear A e a translação t. Compor uma cadeia de transformações numa
+// única matriz permite levar um raio ao espaço do objeto com uma só
+// multiplicação. A direção transformada não é normalizada, de modo que o
+// parâmetro t do raio é o mesmo nos dois espaços.
+struct AffineMatrix {
+    Vector3 rows[3];        // Linhas da parte linear
+    Vector3 translation;
+
+    // Identidade
+    AffineMatrix() : translation(0, 0, 0) {
+        rows[0] = Vector3(1, 0, 0);
+        rows[1] = Vector3(0, 1, 0);
+        rows[2] = Vector3(0, 0, 1);
+    }
+
+    AffineMatrix(const Vector3& row0, const Vector3& row1, const Vector3& row2, const Vector3& translation)
+        : translation(translation) {
+        rows[0] = row0;
+        rows[1] = row1;
+        rows[2] = row2;
+    }
+
+    static AffineMatrix translate(const Vector3& offset) {
+        return AffineMatrix(Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1), offset);
+    }
+
+    static AffineMatrix scale(const Vector3& factors) {
+        return AffineMatrix(Vector3(factors.x, 0, 0), Vector3(0, factors.y, 0), Vector3(0, 0, factors.z),
+                            Vector3(0, 0, 0));
+    }
+
+    // Rotação de "degrees" graus em torno de um eixo unitário (fórmula de Rodrigues)
+    static AffineMatrix rotate(float degrees, const Vector3& axis) {
+        float radians = degrees * float(M_PI) / 180.0f;
+        float c = std::cos(radians), s = std::sin(radians), k = 1.0f - c;
+        return AffineMatrix(
+            Vector3(c + axis.x * axis.x * k, axis.x * axis.y * k - axis.z * s, axis.x * axis.z * k + axis.y * s),
+            Vector3(axis.y * axis.x * k + axis.z * s, c + axis.y * axis.y * k, axis.y * axis.z * k - axis.x * s),
+            Vector3(axis.z * axis.x * k - axis.y * s, axis.z * axis.y * k + axis.x * s, c + axis.z * axis.z * k),
+            Vector3(0, 0, 0));
+    }
+
+    Vector3 transformPoint(const Vector3& p) const {
+        return Vector3(dot(rows[0], p) + translation.x, dot(rows[1], p) + translation.y,
+                       dot(rows[2], p) + translation.z);
+    }
+
+    Vector3 transformVector(const Vector3& v) const {
+        return Vector3(dot(rows[0], v), dot(rows[1], v), dot(rows[2], v));
+    }
+
+    // Transposta da parte linear aplicada a v. Na matriz inversa, leva
+    // normais do espaço do objeto para o espaço de fora (inversa transposta).
+    Vector3 transformTransposed(const Vector3& v) const {
+        return rows[0] * v.x + rows[1] * v.y + rows[2] * v.z;
+    }
+
+    // Versões para pacotes de pontos e vetores em layout SoA
+    template <int N>
+    Vec3x<N> transformPoint(const Vec3x<N>& p) const {
+        Vec3x<N> v = transformVector(p);
+        return Vec3x<N>(v.x + vfloat<N>(translation.x), v.y + vfloat<N>(translation.y),
+                        v.z + vfloat<N>(translation.z));
+    }
+
+    template <int N>
+    Vec3x<N> transformVector(const Vec3x<N>& v) const {
+        return Vec3x<N>(dot(v, Vec3x<N>(rows[0])), dot(v, Vec3x<N>(rows[1])), dot(v, Vec3x<N>(rows[2])));
+    }
+
+    // Composição: (a * b) aplica primeiro b e depois a
+    AffineMatrix operator*(const AffineMatrix& b) const {
+        AffineMatrix result;
+        for (int i = 0; i < 3; i++) {
+            result.rows[i] = Vector3(rows[i].x * b.rows[0].x + rows[i].y * b.rows[1].x + rows[i].z * b.rows[2].x,
+                                     rows[i].x * b.rows[0].y + rows[i].y * b.rows[1].y + rows[i].z * b.rows[2].y,
+                                     rows[i].x * b.rows[0].z + rows[i].y * b.rows[1].z + rows[i].z * b.rows[2].z);
+        }
+        result.translation = transformPoint(b.translation);
+        return result;
+    }
+
+    bool operator==(const AffineMatrix& b) const {
+        for (int i = 0; i < 3; i++) {
+            if (rows[i].x != b.rows[i].x || rows[i].y != b.rows[i].y || rows[i].z != b.rows[i].z) return false;
+        }
+        return translation.x == b.translation.x && translation.y == b.translation.y &&
+               translation.z == b.translation.z;
+    }
+
+    bool operator!=(const AffineMatrix& b) const { return !(*this == b); }
+
+    // Determinante da parte linear (zero para transformações degeneradas)
+    float determinant() const {
+        return dot(rows[0], cross(rows[1], rows[2]));
+    }
+
+    // Inversa: as colunas de A^-1 são os produtos vetoriais das linhas de A
+    // divididos pelo determinante
+    AffineMatrix inverse() const {
+        float invDet = 1.0f / determinant();
+        Vector3 c0 = cross(rows[1], rows[2]) * invDet;
+        Vector3 c1 = cross(rows[2], rows[0]) * invDet;
+        Vector3 c2 = cross(rows[0], rows[1]) * invDet;
+        AffineMatrix result(Vector3(c0.x, c1.x, c2.x), Vector3(c0.y, c1.y, c2.y), Vector3(c0.z, c1.z, c2.z),
+                            Vector3(0, 0, 0));
+        result.translation = -result.transformVector(translation);
+        return result;
+    }
+};
+
+#endif // AFFINE_MATRIX_H
@@ -0,0 +1,76 @@
+#ifndef ALIGNED_ARRAY_H
+#define ALIGNED_ARRAY_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+// Array de tamanho fixo de elementos triviais (copiáveis com memcpy) com o
+// início alinhado à linha de cache: um elemento de 64 bytes nunca cruza duas
+// linhas. Mesma alocação do Framebuffer (malloc com folga e ponteiro alinhado).
+template <typename T>
+class AlignedArray {
+public:
+    static const size_t Alignment = 64;
+
+    AlignedArray() : memory(nullptr), items(nullptr), count(0) {}
+
+    explicit AlignedArray(size_t size) : AlignedArray() { resize(size); }
+
+    AlignedArray(const AlignedArray& other) : AlignedArray() {
+        resize(other.count);
+        if (count > 0) std::memcpy(items, other.items, count * sizeof(T));
+    }
+
+    AlignedArray(AlignedArray&& other) : AlignedArray() { swap(other); }
+
+    AlignedArray& operator=(AlignedArray other) {
+        swap(other);
+        return *this;
+    }
+
+    ~AlignedArray() { std::free(memory); }
+
+    // Descarta o conteúdo e aloca "size" elementos não inicializados
+    void resize(size_t size) {
+        clear();
+        if (size == 0) return;
+        memory = std::malloc(size * sizeof(T) + Alignment);
+        if (!memory) throw std::bad_alloc();
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory) + Alignment - 1) &
+                            ~static_cast<uintptr_t>(Alignment - 1);
+        items = reinterpret_cast<T*>(aligned);
+        count = size;
+    }
+
+    void clear() {
+        std::free(memory);
+        memory = nullptr;
+        items = nullptr;
+        count = 0;
+    }
+
+    void swap(AlignedArray& other) {
+        std::swap(memory, other.memory);
+        std::swap(items, other.items);
+        std::swap(count, other.count);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t byteSize() const { return count * sizeof(T); }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T* data() { return items; }
+    const T* data() const { return items; }
+
+private:
+    void* memory;   // Bloco alocado (liberado no destrutor)
+    T* items;       // Primeiro elemento, alinhado dentro do bloco
+    size_t count;
+};
+
+#endif // ALIGNED_ARRAY_H
@@ -2,6 +2,7 @@
 #define COLOR_H
 
 #include <algorithm>
+#include <cmath>
 #include "Vector3.h"
 
 class Color {
@@ -12,14 +13,8 @@ public:
     Color() : r(0), g(0), b(0) {}
     Color(float r, float g, float b) : r(r), g(g), b(b) {}
     Color(const Vector3& v) : r(v.x), g(v.y), b(v.z) {}
-    Color(const Color& c) : r(c.r), g(c.g), b(c.b) {}
-
-    // Operadores
-    Color& operator=(const Color& c) {
-        r = c.r; g = c.g; b = c.b;
-        return *this;
-    }
 
+    // Operadores (cópia e atribuição implícitas: a classe é trivialmente copiável)
     Color operator+(const Color& c) const {
         return Color(r + c.r, g + c.g, b + c.b);
     }
@@ -63,6 +58,11 @@ public:
         b = std::max(0.0f, std::min(1.0f, b));
     }
 
+    // Maior componente (usada como contribuição restante de um caminho)
+    float maxComponent() const {
+        return std::max(r, std::max(g, b));
+    }
+
     Vector3 toVector3() const {
         return Vector3(r, g, b);
     }
@@ -73,9 +73,29 @@ public:
     unsigned char getB255() const { return static_cast<unsigned char>(255.99f * std::max(0.0f, std::min(1.0f, b))); }
 };
 
+static_assert(std::is_trivially_copyable<Color>::value, "Color deve ser trivialmente copiável");
+
 // Operadores externos
 inline Color operator*(float t, const Color& c) {
     return c * t;
 }
 
+// Converte radiância linear para a cor exibida: correção gamma seguida de
+// uma curva de exposição exponencial
+inline Color toneMap(const Color& radiance, float exposure) {
+    // Correção gamma (usando pow para ser mais preciso)
+    Color color(
+        std::pow(radiance.r, 1.0f/2.2f),
+        std::pow(radiance.g, 1.0f/2.2f),
+        std::pow(radiance.b, 1.0f/2.2f)
+    );
+    
+    // Ajustar exposição para ter um resultado mais próximo da referência
+    return Color(
+        1.0f - std::exp(-color.r * exposure),
+        1.0f - std::exp(-color.g * exposure),
+        1.0f - std::exp(-color.b * exposure)
+    );
+}
+
 #endif // COLOR_H 
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef COLORX_H
+#define COLORX_H
+
+#include "Simd.h"
+#include "Color.h"
+
+// N cores em layout SoA, usadas no sombreamento de pacotes de raios
+template <int N>
+struct Colorx {
+    vfloat<N> r, g, b;
+
+    Colorx() : r(0.0f), g(0.0f), b(0.0f) {}
+    Colorx(const vfloat<N>& r, const vfloat<N>& g, const vfloat<N>& b) : r(r), g(g), b(b) {}
+
+    // A mesma cor em todas as lanes
+    explicit Colorx(const Color& c) : r(c.r), g(c.g), b(c.b) {}
+
+    // Converte N cores consecutivas (AoS) para SoA
+    static Colorx load(const Color* c) {
+        float a[3][N];
+        for (int i = 0; i < N; i++) {
+            a[0][i] = c[i].r; a[1][i] = c[i].g; a[2][i] = c[i].b;
+        }
+        return Colorx(vfloat<N>::load(a[0]), vfloat<N>::load(a[1]), vfloat<N>::load(a[2]));
+    }
+
+    // Cor de uma lane
+    Color get(int lane) const { return Color(r[lane], g[lane], b[lane]); }
+
+    Colorx operator+(const Colorx& c) const { return Colorx(r + c.r, g + c.g, b + c.b); }
+    Colorx operator*(const Colorx& c) const { return Colorx(r * c.r, g * c.g, b * c.b); }
+    Colorx operator*(const vfloat<N>& t) const { return Colorx(r * t, g * t, b * t); }
+
+    Colorx& operator+=(const Colorx& c) { r = r + c.r; g = g + c.g; b = b + c.b; return *this; }
+};
+
+// m ? a : b, lane a lane
+template <int N>
+inline Colorx<N> select(const vbool<N>& m, const Colorx<N>& a, const Colorx<N>& b) {
+    return Colorx<N>(select(m, a.r, b.r), select(m, a.g, b.g), select(m, a.b, b.b));
+}
+
+typedef Colorx<4> Colorx4;
+typedef Colorx<8> Colorx8;
+typedef Colorx<16> Colorx16;
+
+#endif // COLORX_H
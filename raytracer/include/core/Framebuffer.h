@@ -0,0 +1,151 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "Color.h"
+
+// Imagem em ponto flutuante com canais opcionais (AOVs) numa única alocação
+// contígua alinhada a 64 bytes. Cada canal ocupa um plano próprio, com linhas
+// de comprimento arredondado para múltiplos da linha de cache: tiles cuja
+// largura e posição são múltiplas de 16 pixels nunca compartilham linhas de
+// cache, evitando falso compartilhamento entre threads.
+// A linha 0 é a linha superior da imagem.
+class Framebuffer {
+public:
+    // Canais disponíveis (combináveis como máscara de bits)
+    enum Channel {
+        Radiance    = 1 << 0,   // Radiância linear média (RGB), sempre presente
+        Albedo      = 1 << 1,   // Cor difusa na primeira interseção (RGB)
+        Normal      = 1 << 2,   // Normal na primeira interseção (XYZ)
+        Depth       = 1 << 3,   // Distância até a primeira interseção
+        SampleCount = 1 << 4,   // Número de amostras acumuladas
+        Variance    = 1 << 5    // Variância da luminância das amostras
+    };
+    static const int ChannelCount = 6;
+    static const int CacheLineSize = 64;
+
+    Framebuffer() : width(0), height(0), channels(0), memory(nullptr), data(nullptr), byteSize(0) {
+        std::memset(planeOffset, 0, sizeof(planeOffset));
+        std::memset(rowStride, 0, sizeof(rowStride));
+    }
+
+    Framebuffer(int width, int height, unsigned int channels = Radiance)
+        : width(width), height(height), channels(channels | Radiance),
+          memory(nullptr), data(nullptr), byteSize(0) {
+        allocate();
+    }
+
+    ~Framebuffer() { std::free(memory); }
+
+    Framebuffer(Framebuffer&& other) : Framebuffer() { swap(other); }
+
+    Framebuffer& operator=(Framebuffer&& other) {
+        swap(other);
+        return *this;
+    }
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    bool hasChannel(Channel channel) const { return (channels & channel) != 0; }
+
+    // Número de floats por pixel do canal
+    static int components(Channel channel) {
+        return (channel == Radiance || channel == Albedo || channel == Normal) ? 3 : 1;
+    }
+
+    // Ponteiro para o início da linha y do canal (nullptr se o canal não existe)
+    float* row(Channel channel, int y) {
+        int c = channelIndex(channel);
+        return hasChannel(channel) ? data + planeOffset[c] + static_cast<size_t>(y) * rowStride[c] : nullptr;
+    }
+
+    const float* row(Channel channel, int y) const {
+        return const_cast<Framebuffer*>(this)->row(channel, y);
+    }
+
+    float* pixel(Channel channel, int x, int y) {
+        return row(channel, y) + x * components(channel);
+    }
+
+    const float* pixel(Channel channel, int x, int y) const {
+        return row(channel, y) + x * components(channel);
+    }
+
+    // Acesso a canais RGB como Color
+    Color getColor(Channel channel, int x, int y) const {
+        const float* p = pixel(channel, x, y);
+        return Color(p[0], p[1], p[2]);
+    }
+
+    void setColor(Channel channel, int x, int y, const Color& c) {
+        float* p = pixel(channel, x, y);
+        p[0] = c.r; p[1] = c.g; p[2] = c.b;
+    }
+
+    // Acesso a canais escalares
+    float getValue(Channel channel, int x, int y) const { return *pixel(channel, x, y); }
+    void setValue(Channel channel, int x, int y, float value) { *pixel(channel, x, y) = value; }
+
+    // Total de bytes alocados
+    size_t memoryFootprint() const { return byteSize; }
+
+private:
+    int width;
+    int height;
+    unsigned int channels;
+    void* memory;                           // Alocação original
+    float* data;                            // Início alinhado a 64 bytes
+    size_t byteSize;
+    size_t planeOffset[ChannelCount];       // Deslocamento de cada plano (em floats)
+    size_t rowStride[ChannelCount];         // Comprimento das linhas de cada plano (em floats)
+
+    static int channelIndex(Channel channel) {
+        int index = 0;
+        while ((1u << index) != static_cast<unsigned int>(channel)) index++;
+        return index;
+    }
+
+    void allocate() {
+        const size_t floatsPerLine = CacheLineSize / sizeof(float);
+        size_t total = 0;
+        for (int c = 0; c < ChannelCount; c++) {
+            Channel channel = static_cast<Channel>(1 << c);
+            planeOffset[c] = total;
+            rowStride[c] = 0;
+            if (!hasChannel(channel)) continue;
+            size_t rowFloats = static_cast<size_t>(width) * components(channel);
+            rowStride[c] = (rowFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+            total += rowStride[c] * height;
+        }
+
+        byteSize = total * sizeof(float);
+        memory = std::malloc(byteSize + CacheLineSize);
+        if (!memory) throw std::bad_alloc();
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory) + CacheLineSize - 1) &
+                            ~static_cast<uintptr_t>(CacheLineSize - 1);
+        data = reinterpret_cast<float*>(aligned);
+        std::memset(data, 0, byteSize);
+    }
+
+    void swap(Framebuffer& other) {
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(channels, other.channels);
+        std::swap(memory, other.memory);
+        std::swap(data, other.data);
+        std::swap(byteSize, other.byteSize);
+        for (int c = 0; c < ChannelCount; c++) {
+            std::swap(planeOffset[c], other.planeOffset[c]);
+            std::swap(rowStride[c], other.rowStride[c]);
+        }
+    }
+};
+
+#endif // FRAMEBUFFER_H
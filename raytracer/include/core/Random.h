@@ -0,0 +1,47 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cstring>
+
+// Função de mistura de 64 bits (finalizador do SplitMix64)
+inline uint64_t mixBits(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Representação binária de um float, para uso como chave de hash
+inline uint32_t floatBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Gerador de números aleatórios baseado em contador. Cada número é um hash
+// de (semente, pixel, amostra, dimensão), sem estado compartilhado: qualquer
+// thread pode criar o seu gerador na pilha, e o resultado de uma amostra não
+// depende de quantas threads renderizam o quadro nem da ordem de execução.
+class RNG {
+public:
+    RNG(uint64_t seed, uint64_t pixel, uint64_t sampleIndex)
+        : key(mixBits(mixBits(mixBits(seed) ^ pixel) ^ sampleIndex)), dimension(0) {}
+
+    // Posiciona o gerador numa dimensão específica da amostra
+    void setDimension(uint32_t d) { dimension = d; }
+
+    uint32_t nextUInt() {
+        return static_cast<uint32_t>(mixBits(key + 0x9e3779b97f4a7c15ULL * ++dimension) >> 32);
+    }
+
+    // Número uniforme em [0, 1)
+    float nextFloat() {
+        return (nextUInt() >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    uint64_t key;           // Hash de semente, pixel e amostra
+    uint32_t dimension;     // Contador de dimensão
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,85 @@
+#ifndef RAY_PACKET_H
+#define RAY_PACKET_H
+
+#include <algorithm>
+#include "Ray.h"
+#include "Simd.h"
+#include "Vec3x.h"
+#include "Colorx.h"
+
+// Número de raios por pacote: a largura SIMD nativa (4, 8 ou 16)
+static const int PacketSize = SimdWidth;
+typedef vfloat<PacketSize> PacketFloat;
+typedef vbool<PacketSize> PacketMask;
+typedef Vec3x<PacketSize> PacketVec3;
+typedef Colorx<PacketSize> PacketColor;
+
+// Pacote de raios coerentes em layout SoA (uma componente de todos os raios
+// por registrador). Usado nos raios primários, que saem do mesmo ponto em
+// direções próximas e por isso percorrem quase os mesmos nós da BVH.
+struct RayPacket {
+    PacketVec3 origin;
+    PacketVec3 direction;
+    PacketVec3 invDirection;    // Inverso de cada componente da direção
+    PacketMask active;          // Lanes com raios válidos
+
+    RayPacket(const PacketVec3& origin, const PacketVec3& direction, const PacketMask& active)
+        : origin(origin), direction(direction), active(active) {
+        computeInverse();
+    }
+
+    // Monta o pacote com os "count" primeiros raios (até PacketSize). As
+    // lanes que sobram repetem o último raio e ficam inativas.
+    RayPacket(const Ray* rays, int count) {
+        Vector3 o[PacketSize], d[PacketSize];
+        for (int lane = 0; lane < PacketSize; lane++) {
+            const Ray& ray = rays[std::min(lane, count - 1)];
+            o[lane] = ray.origin;
+            d[lane] = ray.direction;
+        }
+        origin = PacketVec3::load(o);
+        direction = PacketVec3::load(d);
+        computeInverse();
+        active = PacketMask::fromBits(count >= PacketSize ? ~0u : (1u << count) - 1u);
+    }
+
+    // Raio de uma lane
+    Ray ray(int lane) const {
+        return Ray(origin.get(lane), direction.get(lane));
+    }
+
+    void computeInverse() {
+        PacketFloat one(1.0f);
+        invDirection = PacketVec3(one / direction.x, one / direction.y, one / direction.z);
+    }
+};
+
+// Interseções mais próximas de um pacote: distância e índice do primitivo
+// atingido em cada lane (-1 enquanto a lane não atingiu nada)
+struct PacketHit {
+    PacketFloat t;
+    int primitive[PacketSize];
+
+    explicit PacketHit(float tMax) : t(tMax) {
+        for (int lane = 0; lane < PacketSize; lane++) primitive[lane] = -1;
+    }
+
+    // Registra a interseção com o primitivo "index" nas lanes de "mask"
+    void update(const PacketMask& mask, const PacketFloat& tHit, int index) {
+        t = select(mask, tHit, t);
+        for (unsigned int bits = mask.bits(); bits; bits &= bits - 1) {
+            primitive[lowestLane(bits)] = index;
+        }
+    }
+
+    // Registra a interseção de uma única lane
+    void update(int lane, float tHit, int index) {
+        float values[PacketSize];
+        t.store(values);
+        values[lane] = tHit;
+        t = PacketFloat::load(values);
+        primitive[lane] = index;
+    }
+};
+
+#endif // RAY_PACKET_H
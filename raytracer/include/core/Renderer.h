@@ -5,87 +5,145 @@
 #include <iostream>
 #include <fstream>
 #include <limits>
-#include <cstdlib>  // Para rand()
-#include <functional> // Para std::function
-#include <random>   // Para gerador de números aleatórios de melhor qualidade
-#include <algorithm> // Para std::clamp
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "Camera.h"
 #include "Color.h"
+#include "TileScheduler.h"
+#include "Framebuffer.h"
+#include "WavefrontIntegrator.h"
 #include "../geometry/Scene.h"
-#include "../material/ReflectiveMaterial.h"
+#include "../material/MaterialKernels.h"
+#include "../sampler/IndependentSampler.h"
+#include "../sampler/SobolSampler.h"
+#include "../sampler/HaltonSampler.h"
+#include "../sampler/BlueNoiseSampler.h"
+#include "../io/PPMWriter.h"
+#include "../io/PNGWriter.h"
+#include "../io/PFMWriter.h"
+#include "../io/EXRWriter.h"
+
+// Integradores disponíveis no Renderer
+enum class IntegratorType {
+    Recursive,      // Um caminho por vez, com recursão nas reflexões (traceRay)
+    Iterative,      // Um caminho por vez, em laço, com roleta russa (tracePath)
+    Wavefront       // Milhares de caminhos por estágio, com filas ordenadas (WavefrontIntegrator)
+};
 
 class Renderer {
 public:
     int width;              // Largura da imagem em pixels
     int height;             // Altura da imagem em pixels
-    int samplesPerPixel;    // Número de amostras por pixel
-    int maxDepth;           // Profundidade máxima de raios recursivos
+    int samplesPerPixel;    // Número de amostras por pixel (máximo, no modo adaptativo)
+    int maxDepth;           // Profundidade máxima de raios recursivos (limite de segurança no Iterative)
+    int tileSize;           // Lado dos tiles (em pixels) distribuídos entre as threads
+    TileOrder tileOrder;    // Ordem de percurso dos tiles
+    unsigned int seed;      // Semente dos números aleatórios (mesma semente, mesma imagem)
+    SamplerType samplerType;  // Gerador das posições das amostras dentro dos pixels
+    unsigned int channels;  // Canais extras do Framebuffer (máscara de Framebuffer::Channel)
+    float exposure;         // Exposição aplicada no mapeamento de tons
+    
+    // Amostragem adaptativa: cada pixel recebe lotes de minSamples amostras
+    // até que o erro padrão relativo da luminância média fique abaixo de
+    // errorThreshold, ou até samplesPerPixel amostras
+    bool adaptive;          // Ativa a amostragem adaptativa
+    int minSamples;         // Tamanho de cada lote (e mínimo de amostras por pixel)
+    float errorThreshold;   // Erro relativo máximo aceito
+    
+    // Raios primários agrupados em pacotes de PacketSize raios (4, 8 ou 16,
+    // conforme o conjunto de instruções SIMD da compilação), que percorrem a
+    // BVH e testam as esferas e caixas juntos
+    bool packetTracing;
+    
+    // Integrador usado nos caminhos; o Wavefront sempre traça pacotes
+    IntegratorType integrator;
+    
+    // Término dos caminhos no integrador Iterative: o caminho acaba quando a
+    // contribuição restante (maior componente da vazão) fica abaixo de
+    // minThroughput; a partir da profundidade rouletteDepth, continua com
+    // probabilidade igual a essa contribuição (roleta russa), com a vazão
+    // dividida pela probabilidade para manter a média
+    float minThroughput;
+    int rouletteDepth;
     
     // Construtor
     Renderer(int width, int height, int samplesPerPixel = 1, int maxDepth = 5)
-        : width(width), height(height), samplesPerPixel(samplesPerPixel), maxDepth(maxDepth) {
-        // Inicializar gerador de números aleatórios
-        std::random_device rd;
-        gen = std::mt19937(rd());
-        dist = std::uniform_real_distribution<float>(0.0f, 1.0f);
-    }
+        : width(width), height(height), samplesPerPixel(samplesPerPixel), maxDepth(maxDepth),
+          tileSize(16), tileOrder(TileOrder::Hilbert), seed(0), samplerType(SamplerType::Sobol),
+          channels(Framebuffer::Radiance), exposure(1.2f),
+          adaptive(false), minSamples(16), errorThreshold(0.02f), packetTracing(true),
+          integrator(IntegratorType::Recursive), minThroughput(0.001f), rouletteDepth(3) {}
     
-    // Renderiza a cena e retorna uma matriz de pixels
-    std::vector<std::vector<Color>> render(const Scene& scene, const Camera& camera) {
-        std::vector<std::vector<Color>> pixels(height, std::vector<Color>(width));
+    // Renderiza a cena e retorna a imagem com radiância linear e os canais
+    // extras pedidos em "channels". Com tileSize múltiplo de 16, threads
+    // diferentes nunca escrevem na mesma linha de cache.
+    // Se "writer" for fornecido, cada faixa de linhas é gravada assim que
+    // todos os seus tiles terminam, em ordem, durante a renderização.
+    // No modo adaptativo o canal SampleCount é sempre incluído.
+    Framebuffer render(const Scene& scene, const Camera& camera, ImageWriter* writer = nullptr) {
+        Framebuffer image(width, height, adaptive ? channels | Framebuffer::SampleCount : channels);
         
         // Progresso
         int totalPixels = width * height;
         int pixelsProcessed = 0;
         int lastPercentage = 0;
         
-        #pragma omp parallel for collapse(2) schedule(dynamic, 1)
-        for (int j = 0; j < height; j++) {
-            for (int i = 0; i < width; i++) {
-                Color pixelColor(0, 0, 0);
+        // Tiles distribuídos entre as threads com roubo de trabalho
+        int bandHeight = std::max(1, tileSize);
+        TileScheduler scheduler(width, height, bandHeight, tileOrder, maxThreads());
+        
+        // Faixas de linhas (uma por linha de tiles) e tiles restantes em cada uma
+        int tilesPerBand = (width + bandHeight - 1) / bandHeight;
+        int bandCount = (height + bandHeight - 1) / bandHeight;
+        std::vector<std::atomic<int>> tilesRemaining(bandCount);
+        for (int b = 0; b < bandCount; b++) tilesRemaining[b].store(tilesPerBand);
+        int nextBand = 0;
+        std::mutex writerMutex;
+        
+        if (writer && !writer->begin(width, height)) {
+            writer = nullptr;
+        }
+        
+        // Compartilhado entre as threads: os amostradores não guardam estado
+        std::unique_ptr<Sampler> sampler = createSampler();
+        
+        #pragma omp parallel
+        {
+            int thread = threadIndex();
+            Tile tile;
+            std::vector<PixelStats> stats;  // Acumuladores do tile corrente
+            std::vector<char> active;
+            PrimaryBatch batch;
+            
+            while (scheduler.next(thread, tile)) {
+                renderTile(scene, camera, *sampler, tile, image, stats, active, batch);
                 
-                // Múltiplas amostras por pixel para antialiasing com distribuição melhorada
-                for (int s = 0; s < samplesPerPixel; s++) {
-                    // Utilizando distribuição estratificada para melhor cobertura do pixel
-                    int sqrtSamples = std::sqrt(samplesPerPixel);
-                    int sx = s % sqrtSamples;
-                    int sy = s / sqrtSamples;
-                    
-                    float u = float(i + (sx + randomFloat()) / sqrtSamples) / float(width);
-                    float v = float(j + (sy + randomFloat()) / sqrtSamples) / float(height);
-                    
-                    Ray ray = camera.getRay(u, v);
-                    pixelColor += traceRay(ray, scene, 0);
+                // A última thread a concluir um tile da faixa grava as faixas prontas
+                int band = tile.y0 / bandHeight;
+                if (writer && tilesRemaining[band].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(writerMutex);
+                    while (nextBand < bandCount &&
+                           tilesRemaining[nextBand].load(std::memory_order_acquire) == 0) {
+                        int y0 = nextBand * bandHeight;
+                        writer->writeRows(image, y0, std::min(y0 + bandHeight, height));
+                        nextBand++;
+                    }
                 }
                 
-                // Média das amostras
-                pixelColor = pixelColor / float(samplesPerPixel);
-                
-                // Correção gamma (usando pow para ser mais preciso)
-                pixelColor = Color(
-                    std::pow(pixelColor.r, 1.0f/2.2f),
-                    std::pow(pixelColor.g, 1.0f/2.2f),
-                    std::pow(pixelColor.b, 1.0f/2.2f)
-                );
-                
-                // Ajustar exposição para ter um resultado mais próximo da referência
-                float exposure = 1.2f;
-                pixelColor = Color(
-                    1.0f - std::exp(-pixelColor.r * exposure),
-                    1.0f - std::exp(-pixelColor.g * exposure),
-                    1.0f - std::exp(-pixelColor.b * exposure)
-                );
-                
-                pixels[height - j - 1][i] = pixelColor; // Inverter eixo Y para origem no canto inferior esquerdo
-                
                 // Atualizar progresso
-                #pragma omp atomic
-                pixelsProcessed++;
+                int processed;
+                #pragma omp atomic capture
+                processed = pixelsProcessed += tile.pixelCount();
                 
-                if (pixelsProcessed * 100 / totalPixels > lastPercentage) {
+                if (processed * 100LL / totalPixels > lastPercentage) {
                     #pragma omp critical
                     {
-                        int currentPercentage = pixelsProcessed * 100 / totalPixels;
+                        int currentPercentage = static_cast<int>(processed * 100LL / totalPixels);
                         if (currentPercentage > lastPercentage) {
                             lastPercentage = currentPercentage;
                             std::cerr << "\rRendering: " << lastPercentage << "% " << std::flush;
@@ -96,99 +154,603 @@ public:
         }
         
         std::cerr << "\rRendering: 100% \n";
-        return pixels;
+        if (adaptive) {
+            std::cerr << "Amostras por pixel (média): " << averageSamples(image) << std::endl;
+        }
+        if (writer) writer->end();
+        return image;
+    }
+    
+    // Converte radiância linear para a cor exibida
+    Color toneMap(const Color& radiance) const {
+        return ::toneMap(radiance, exposure);
+    }
+    
+    // Salva a imagem em formato PPM (binário P6 por padrão, ou ASCII P3)
+    bool saveToPPM(const Framebuffer& image, const std::string& filename, bool binary = true) const {
+        PPMWriter writer(filename, exposure, binary);
+        return writer.write(image);
+    }
+    
+    // Salva a imagem em formato PNG comprimido (8 bits, com mapeamento de tons)
+    bool saveToPNG(const Framebuffer& image, const std::string& filename) const {
+        PNGWriter writer(filename, exposure);
+        return writer.write(image);
+    }
+    
+    // Salva um canal em PFM, sem mapeamento de tons (radiância linear por padrão)
+    bool saveToPFM(const Framebuffer& image, const std::string& filename,
+                   Framebuffer::Channel channel = Framebuffer::Radiance) const {
+        PFMWriter writer(filename, channel);
+        return writer.write(image);
+    }
+    
+    // Salva a radiância linear em OpenEXR (compressão ZIP por padrão)
+    bool saveToEXR(const Framebuffer& image, const std::string& filename,
+                   EXRWriter::Compression compression = EXRWriter::Zip) const {
+        EXRWriter writer(filename, compression);
+        return writer.write(image);
+    }
+    
+    // Salva em PNG o mapa de calor das amostras usadas por pixel (canal
+    // SampleCount), de preto (nenhuma) a branco (samplesPerPixel)
+    bool saveSampleHeatmap(const Framebuffer& image, const std::string& filename) const {
+        if (!image.hasChannel(Framebuffer::SampleCount)) {
+            std::cerr << "Erro: o Framebuffer não possui o canal SampleCount" << std::endl;
+            return false;
+        }
+        Framebuffer heatmap(image.getWidth(), image.getHeight());
+        for (int y = 0; y < image.getHeight(); y++) {
+            for (int x = 0; x < image.getWidth(); x++) {
+                float t = image.getValue(Framebuffer::SampleCount, x, y) / float(samplesPerPixel);
+                heatmap.setColor(Framebuffer::Radiance, x, y, heatColor(t));
+            }
+        }
+        PNGWriter writer(filename, exposure, false);
+        return writer.write(heatmap);
+    }
+    
+    // Média de amostras por pixel de uma imagem com o canal SampleCount
+    static double averageSamples(const Framebuffer& image) {
+        if (!image.hasChannel(Framebuffer::SampleCount)) return 0.0;
+        double total = 0.0;
+        for (int y = 0; y < image.getHeight(); y++) {
+            const float* row = image.row(Framebuffer::SampleCount, y);
+            for (int x = 0; x < image.getWidth(); x++) total += row[x];
+        }
+        return total / std::max(1.0, double(image.getWidth()) * image.getHeight());
     }
     
-    // Salva a imagem em formato PPM
-    void saveToPPM(const std::vector<std::vector<Color>>& pixels, const std::string& filename) {
-        std::ofstream file(filename, std::ios::out);
+private:
+    // Acumuladores de um pixel durante a amostragem
+    struct PixelStats {
+        Color radiance;
+        Color albedo;
+        Vector3 normal;
+        float depth;
+        float lumMean;      // Média da luminância (Welford)
+        float lumM2;        // Soma dos quadrados das diferenças da luminância
+        int samples;
+        
+        PixelStats() : radiance(0, 0, 0), albedo(0, 0, 0), normal(0, 0, 0),
+                       depth(0.0f), lumMean(0.0f), lumM2(0.0f), samples(0) {}
+    };
+    
+    // Raios primários aguardando o traçado em pacote (ou pelo integrador
+    // wavefront), com o pixel e o acumulador de cada um
+    struct PrimaryBatch {
+        std::vector<Ray> rays;
+        std::vector<PixelSample> samples;
+        std::vector<PixelStats*> stats;
+        int count;
         
-        // Cabeçalho do arquivo PPM
-        file << "P3\n" << width << " " << height << "\n255\n";
+        WavefrontIntegrator wavefront;
+        std::vector<WavefrontIntegrator::Path> paths;
         
-        // Pixels
-        for (const auto& row : pixels) {
-            for (const auto& pixel : row) {
-                file << static_cast<int>(pixel.getR255()) << ' '
-                     << static_cast<int>(pixel.getG255()) << ' '
-                     << static_cast<int>(pixel.getB255()) << '\n';
+        PrimaryBatch() : count(0) {}
+        
+        void push(const Ray& ray, const PixelSample& sample, PixelStats* pixel) {
+            if (count == static_cast<int>(rays.size())) {
+                rays.push_back(ray);
+                samples.push_back(sample);
+                stats.push_back(pixel);
+            } else {
+                rays[count] = ray;
+                samples[count] = sample;
+                stats[count] = pixel;
+            }
+            count++;
+        }
+    };
+    
+    // Calcula os pixels de um tile. Sem amostragem adaptativa, cada pixel
+    // recebe samplesPerPixel amostras de uma vez. No modo adaptativo, o tile
+    // é amostrado em rodadas de um lote por pixel; um pixel continua ativo
+    // enquanto ele ou algum vizinho não convergiu, o que evita parar cedo em
+    // pixels cujas primeiras amostras não viram um evento raro (uma sombra
+    // parcial, por exemplo) que os vizinhos já encontraram.
+    void renderTile(const Scene& scene, const Camera& camera, const Sampler& sampler, const Tile& tile,
+                    Framebuffer& image,
+                    std::vector<PixelStats>& stats, std::vector<char>& active, PrimaryBatch& batch) const {
+        int tileWidth = tile.x1 - tile.x0;
+        int tileHeight = tile.y1 - tile.y0;
+        stats.assign(static_cast<size_t>(tileWidth) * tileHeight, PixelStats());
+        
+        if (!adaptive) {
+            for (int y = tile.y0; y < tile.y1; y++) {
+                for (int x = tile.x0; x < tile.x1; x++) {
+                    PixelStats& p = stats[(y - tile.y0) * tileWidth + (x - tile.x0)];
+                    addSamples(scene, camera, sampler, x, y, samplesPerPixel, p, image, batch);
+                }
+            }
+            traceBatch(scene, batch, image);
+            
+            for (int y = tile.y0; y < tile.y1; y++) {
+                for (int x = tile.x0; x < tile.x1; x++) {
+                    writePixel(x, y, stats[(y - tile.y0) * tileWidth + (x - tile.x0)], image);
+                }
+            }
+            return;
+        }
+        
+        // Os lotes continuam a sequência do amostrador: com Sobol, lotes de
+        // 2^k amostras mantêm cada prefixo estratificado
+        int batchSize = std::max(1, minSamples);
+        
+        active.assign(stats.size(), 1);
+        std::vector<char> done(stats.size(), 0);
+        bool anyActive = true;
+        while (anyActive) {
+            for (int y = tile.y0; y < tile.y1; y++) {
+                for (int x = tile.x0; x < tile.x1; x++) {
+                    int k = (y - tile.y0) * tileWidth + (x - tile.x0);
+                    if (!active[k]) continue;
+                    int count = std::min(batchSize, samplesPerPixel - stats[k].samples);
+                    addSamples(scene, camera, sampler, x, y, count, stats[k], image, batch);
+                }
+            }
+            traceBatch(scene, batch, image);
+            
+            for (size_t k = 0; k < stats.size(); k++) {
+                done[k] = stats[k].samples >= samplesPerPixel || converged(stats[k]);
+            }
+            
+            // Pixel ativo: ainda há orçamento e a vizinhança 3x3 não convergiu
+            anyActive = false;
+            for (int ty = 0; ty < tileHeight; ty++) {
+                for (int tx = 0; tx < tileWidth; tx++) {
+                    int k = ty * tileWidth + tx;
+                    active[k] = 0;
+                    if (stats[k].samples >= samplesPerPixel) continue;
+                    for (int dy = -1; dy <= 1 && !active[k]; dy++) {
+                        for (int dx = -1; dx <= 1; dx++) {
+                            int nx = tx + dx, ny = ty + dy;
+                            if (nx < 0 || ny < 0 || nx >= tileWidth || ny >= tileHeight) continue;
+                            if (!done[ny * tileWidth + nx]) {
+                                active[k] = 1;
+                                break;
+                            }
+                        }
+                    }
+                    anyActive = anyActive || active[k];
+                }
             }
         }
         
-        file.close();
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                writePixel(x, y, stats[(y - tile.y0) * tileWidth + (x - tile.x0)], image);
+            }
+        }
+    }
+    
+    // Acrescenta "count" amostras ao pixel (x, y), continuando a sequência já
+    // acumulada. As dimensões 0 e 1 do amostrador dão a posição dentro do
+    // pixel. A linha y = 0 é o topo da imagem; a câmera usa v crescendo para cima.
+    // Com packetTracing ou o integrador wavefront, os raios entram em "batch"
+    // e são traçados quando o lote fica cheio (ou em traceBatch); as amostras
+    // de cada pixel são acumuladas na mesma ordem do traçado individual.
+    void addSamples(const Scene& scene, const Camera& camera, const Sampler& sampler, int x, int y,
+                    int count, PixelStats& p, const Framebuffer& image, PrimaryBatch& batch) const {
+        int i = x;
+        int j = height - y - 1;
+        bool needsPrimary = needsPrimaryHit(image);
+        uint32_t first = static_cast<uint32_t>(p.samples);
+        
+        for (int n = 0; n < count; n++) {
+            uint32_t index = first + static_cast<uint32_t>(n);
+            float px, py;
+            sampler.get2D(x, y, index, 0, px, py);
+            float u = (float(i) + px) / float(width);
+            float v = (float(j) + py) / float(height);
+            
+            Ray ray = camera.getRay(u, v);
+            PixelSample pixelSample = {&sampler, x, y, index};
+            
+            if (packetTracing || integrator == IntegratorType::Wavefront) {
+                batch.push(ray, pixelSample, &p);
+                if (batch.count == batchCapacity()) traceBatch(scene, batch, image);
+                continue;
+            }
+            
+            HitRecord primary;
+            Color sample = integrator == IntegratorType::Iterative
+                ? tracePath(ray, scene, pixelSample, needsPrimary ? &primary : nullptr)
+                : traceRay(ray, scene, 0, pixelSample, needsPrimary ? &primary : nullptr);
+            accumulate(p, sample, needsPrimary && primary.material ? &primary : nullptr);
+        }
+    }
+    
+    int batchCapacity() const {
+        return integrator == IntegratorType::Wavefront ? WavefrontIntegrator::BatchSize : PacketSize;
+    }
+    
+    // Traça os raios primários pendentes e acumula as amostras nos pixels
+    void traceBatch(const Scene& scene, PrimaryBatch& batch, const Framebuffer& image) const {
+        if (batch.count == 0) return;
+        if (integrator != IntegratorType::Wavefront) {
+            tracePrimaryBatch(scene, batch, image);
+            return;
+        }
+        
+        batch.paths.resize(batch.count);
+        for (int i = 0; i < batch.count; i++) {
+            batch.paths[i].ray = batch.rays[i];
+            batch.paths[i].sample = batch.samples[i];
+        }
+        batch.wavefront.trace(scene, maxDepth, batch.paths);
+        
+        bool needsPrimary = needsPrimaryHit(image);
+        for (int i = 0; i < batch.count; i++) {
+            const WavefrontIntegrator::Path& path = batch.paths[i];
+            accumulate(*batch.stats[i], path.radiance, needsPrimary && path.primary.material ? &path.primary : nullptr);
+        }
+        batch.count = 0;
+    }
+    
+    // Traça os raios primários pendentes como um pacote. A BVH e as
+    // primitivas só determinam o objeto mais próximo de cada lane; o registro
+    // de interseção completo vem do hit escalar desse objeto. A iluminação
+    // direta também é calculada para o pacote inteiro; os raios secundários
+    // seguem raio a raio, pelo integrador escolhido.
+    void tracePrimaryBatch(const Scene& scene, PrimaryBatch& batch, const Framebuffer& image) const {
+        if (batch.count == 0) return;
+        bool needsPrimary = needsPrimaryHit(image);
+        const float tMin = 0.001f;
+        const float infinity = std::numeric_limits<float>::infinity();
+        
+        RayPacket packet(&batch.rays[0], batch.count);
+        PacketHit result(infinity);
+        if (maxDepth > 0) scene.hitPacket(packet, tMin, result);
+        
+        HitRecord records[PacketSize];
+        unsigned int hitBits = 0;
+        for (int lane = 0; lane < batch.count; lane++) {
+            int object = result.primitive[lane];
+            if (object >= 0 && scene.tracedObject(object)->hit(batch.rays[lane], tMin, infinity, records[lane])) {
+                hitBits |= 1u << lane;
+            }
+        }
+        
+        Color direct[PacketSize];
+        calculateDirectLight(packet, scene, records, PacketMask::fromBits(hitBits), &batch.samples[0], direct);
+        
+        for (int lane = 0; lane < batch.count; lane++) {
+            bool hit = (hitBits >> lane) & 1u;
+            Color sample(0.0f, 0.0f, 0.0f);
+            if (hit && integrator == IntegratorType::Iterative) {
+                sample = continuePath(batch.rays[lane], scene, records[lane], batch.samples[lane], direct[lane]);
+            } else if (hit) {
+                sample = addReflection(batch.rays[lane], scene, records[lane], 0, batch.samples[lane], direct[lane]);
+            }
+            accumulate(*batch.stats[lane], sample, needsPrimary && hit ? &records[lane] : nullptr);
+        }
+        batch.count = 0;
+    }
+    
+    bool needsPrimaryHit(const Framebuffer& image) const {
+        return image.hasChannel(Framebuffer::Albedo) ||
+               image.hasChannel(Framebuffer::Normal) ||
+               image.hasChannel(Framebuffer::Depth);
+    }
+    
+    // Soma uma amostra ao pixel; "primary" é a interseção do raio primário
+    // (nula se não houver ou se os canais auxiliares não forem usados)
+    static void accumulate(PixelStats& p, const Color& sample, const HitRecord* primary) {
+        p.radiance += sample;
+        
+        if (primary) {
+            p.albedo += primary->material->diffuse;
+            p.normal += primary->normal;
+            p.depth += primary->t;
+        }
+        
+        float lum = luminance(sample);
+        float delta = lum - p.lumMean;
+        p.samples++;
+        p.lumMean += delta / float(p.samples);
+        p.lumM2 += delta * (lum - p.lumMean);
+    }
+    
+    // Escreve no Framebuffer as médias acumuladas do pixel
+    void writePixel(int x, int y, const PixelStats& p, Framebuffer& image) const {
+        float invSamples = 1.0f / float(std::max(1, p.samples));
+        image.setColor(Framebuffer::Radiance, x, y, p.radiance * invSamples);
+        
+        if (image.hasChannel(Framebuffer::Albedo)) {
+            image.setColor(Framebuffer::Albedo, x, y, p.albedo * invSamples);
+        }
+        if (image.hasChannel(Framebuffer::Normal)) {
+            Vector3 n = p.normal.normalized();
+            float* q = image.pixel(Framebuffer::Normal, x, y);
+            q[0] = n.x; q[1] = n.y; q[2] = n.z;
+        }
+        if (image.hasChannel(Framebuffer::Depth)) {
+            image.setValue(Framebuffer::Depth, x, y, p.depth * invSamples);
+        }
+        if (image.hasChannel(Framebuffer::SampleCount)) {
+            image.setValue(Framebuffer::SampleCount, x, y, float(p.samples));
+        }
+        if (image.hasChannel(Framebuffer::Variance)) {
+            image.setValue(Framebuffer::Variance, x, y, p.samples > 1 ? p.lumM2 / float(p.samples - 1) : 0.0f);
+        }
+    }
+    
+    // Cria o amostrador escolhido em samplerType
+    std::unique_ptr<Sampler> createSampler() const {
+        switch (samplerType) {
+            case SamplerType::Independent: return std::unique_ptr<Sampler>(new IndependentSampler(seed));
+            case SamplerType::Halton:      return std::unique_ptr<Sampler>(new HaltonSampler(seed));
+            case SamplerType::BlueNoise:   return std::unique_ptr<Sampler>(new BlueNoiseSampler(seed));
+            default:                       return std::unique_ptr<Sampler>(new SobolSampler(seed));
+        }
+    }
+    
+    static float luminance(const Color& c) {
+        return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+    }
+    
+    // Critério de parada: erro padrão da luminância média pequeno em relação
+    // à própria média. O piso de 0.05 na média evita que regiões escuras,
+    // onde o ruído é pouco visível, consumam o orçamento máximo.
+    bool converged(const PixelStats& p) const {
+        if (p.samples < 2) return false;
+        float varianceOfMean = p.lumM2 / (float(p.samples - 1) * float(p.samples));
+        float tolerance = errorThreshold * std::max(p.lumMean, 0.05f);
+        return varianceOfMean <= tolerance * tolerance;
+    }
+    
+    // Rampa de cores do mapa de calor: preto, azul, vermelho, amarelo e branco
+    static Color heatColor(float t) {
+        static const Color stops[5] = {
+            Color(0.0f, 0.0f, 0.0f), Color(0.0f, 0.0f, 1.0f), Color(1.0f, 0.0f, 0.0f),
+            Color(1.0f, 1.0f, 0.0f), Color(1.0f, 1.0f, 1.0f)
+        };
+        t = std::min(std::max(t, 0.0f), 1.0f) * 4.0f;
+        int k = std::min(static_cast<int>(t), 3);
+        float f = t - float(k);
+        return stops[k] * (1.0f - f) + stops[k + 1] * f;
     }
     
-private:
-    std::mt19937 gen;                            // Gerador de números aleatórios
-    std::uniform_real_distribution<float> dist;  // Distribuição uniforme
-
     // Traça um raio na cena com recursão para reflexões
-    Color traceRay(const Ray& ray, const Scene& scene, int depth) {
+    // Se primaryHit não for nulo, recebe a interseção do raio (material nulo se não houver)
+    Color traceRay(const Ray& ray, const Scene& scene, int depth, const PixelSample& sample,
+                   HitRecord* primaryHit = nullptr) const {
         if (depth >= maxDepth) return Color(0, 0, 0);
         
         HitRecord record;
         
         // Verificar interseção com a cena
-        if (scene.hit(ray, 0.001f, std::numeric_limits<float>::infinity(), record)) {
-            // Calcular iluminação direta (Phong)
-            Color directColor = calculateDirectLight(ray, scene, record);
-            
-            // Verificar se é um material reflexivo
-            ReflectiveMaterial* reflMat = dynamic_cast<ReflectiveMaterial*>(record.material);
-            if (reflMat != nullptr) {
-                // Calcular reflexão
-                Color reflectedColor = reflMat->calculateReflection(
-                    ray, record, depth,
-                    [this, &scene](const Ray& r, int d) { return this->traceRay(r, scene, d); }
-                );
-                
-                // Combinar cor direta com reflexão
-                return directColor * (1.0f - reflMat->reflectivity) + reflectedColor * reflMat->reflectivity;
-            }
-            
-            // Material não reflexivo - retornar apenas cor direta
-            return directColor;
+        bool hit = scene.hit(ray, 0.001f, std::numeric_limits<float>::infinity(), record);
+        if (primaryHit) {
+            *primaryHit = record;
+            if (!hit) primaryHit->material = nullptr;
         }
         
+        if (hit) return shade(ray, scene, record, depth, sample);
+        
         // Sem interseção - cor de fundo (preto)
         return Color(0.0f, 0.0f, 0.0f);
     }
     
-    // Calcula a iluminação direta em um ponto
-    Color calculateDirectLight(const Ray& ray, const Scene& scene, const HitRecord& record) {
+    // Cor vista por um raio que atingiu a cena no ponto descrito em "record"
+    Color shade(const Ray& ray, const Scene& scene, const HitRecord& record, int depth,
+                const PixelSample& sample) const {
+        // Calcular iluminação direta (Phong)
+        Color directColor = calculateDirectLight(ray, scene, record, depth, sample);
+        return addReflection(ray, scene, record, depth, sample, directColor);
+    }
+    
+    // Combina a iluminação direta de um ponto com o raio secundário do
+    // material (reflexão), traçado aqui mesmo pelo integrador
+    Color addReflection(const Ray& ray, const Scene& scene, const HitRecord& record, int depth,
+                        const PixelSample& sample, const Color& directColor) const {
+        Scatter next = scatter(*record.material, ray, record, sample.pathValue(depth, 0));
+        if (!next.hasRay) return directColor;
+        
+        Color reflectedColor = traceRay(next.ray, scene, depth + 1, sample);
+        return directColor * next.directWeight + reflectedColor * next.weight;
+    }
+    
+    // Estado de um caminho no integrador Iterative
+    struct PathState {
+        Ray ray;
+        Color throughput;   // Fração da luz vista no fim do caminho que chega ao pixel
+        Color radiance;     // Luz já acumulada
+        int depth;
+    };
+    
+    // Traça um caminho sem recursão: cada ponto soma sua luz direta ponderada
+    // pela vazão e o material fornece no máximo um raio seguinte (os
+    // dielétricos sorteiam entre reflexão e refração), então a memória usada
+    // não cresce com a profundidade. Se primaryHit não for nulo, recebe a
+    // interseção do raio primário (material nulo se não houver).
+    Color tracePath(const Ray& ray, const Scene& scene, const PixelSample& sample,
+                    HitRecord* primaryHit = nullptr) const {
+        HitRecord record;
+        bool hit = maxDepth > 0 && scene.hit(ray, 0.001f, std::numeric_limits<float>::infinity(), record);
+        if (primaryHit) {
+            *primaryHit = record;
+            if (!hit) primaryHit->material = nullptr;
+        }
+        if (!hit) return Color(0.0f, 0.0f, 0.0f);
+        
+        return continuePath(ray, scene, record, sample, calculateDirectLight(ray, scene, record, 0, sample));
+    }
+    
+    // Continua o caminho de "ray" a partir da sua primeira interseção, com a
+    // luz direta desse ponto já calculada
+    Color continuePath(const Ray& ray, const Scene& scene, const HitRecord& first, const PixelSample& sample,
+                       const Color& firstDirect) const {
+        PathState path = {ray, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f), 0};
+        HitRecord record = first;
+        Color direct = firstDirect;
+        
+        while (true) {
+            Scatter next = scatter(*record.material, path.ray, record, sample.pathValue(path.depth, 0));
+            path.radiance += path.throughput * direct * next.directWeight;
+            if (!next.hasRay) break;
+            
+            path.throughput *= next.weight;
+            path.ray = next.ray;
+            path.depth++;
+            if (path.depth >= maxDepth) break;
+            
+            // Término pela contribuição restante e roleta russa
+            float contribution = path.throughput.maxComponent();
+            if (contribution < minThroughput) break;
+            if (path.depth >= rouletteDepth && contribution < 1.0f) {
+                if (sample.pathValue(path.depth, 1) >= contribution) break;
+                path.throughput *= 1.0f / contribution;
+            }
+            
+            if (!scene.hit(path.ray, 0.001f, std::numeric_limits<float>::infinity(), record)) break;
+            direct = calculateDirectLight(path.ray, scene, record, path.depth, sample);
+        }
+        return path.radiance;
+    }
+    
+    // Calcula a iluminação direta em um ponto. Cada luz recebe sampleCount()
+    // amostras; os números vêm do Sampler, num par de dimensões próprio para
+    // cada luz e cada profundidade, com índices consecutivos para as amostras
+    // de um mesmo ponto (que assim ficam estratificadas entre si).
+    Color calculateDirectLight(const Ray& ray, const Scene& scene, const HitRecord& record,
+                               int depth, const PixelSample& sample) const {
         // Iluminação ambiente
         Color color = scene.ambientLight.intensity * record.material->ambient;
         
+        uint32_t dimension = 2 + 2 * static_cast<uint32_t>(depth * scene.lights.size());
+        
         // Para cada fonte de luz
-        for (const auto& light : scene.lights) {
-            // Verificar sombra
-            bool inShadow = scene.isShadowed(record.point, light);
+        for (size_t l = 0; l < scene.lights.size(); l++, dimension += 2) {
+            const Light* light = scene.lights[l];
+            int count = light->sampleCount();
+            Color sum(0, 0, 0);
             
-            // Se não estiver na sombra
-            if (!inShadow) {
-                Vector3 lightDir = light->getDirection(record.point);
-                Color lightIntensity = light->getIntensity(record.point);
-                
-                // Calcular fator de atenuação baseado na distância
-                float distance = light->getDistance(record.point);
+            for (int k = 0; k < count; k++) {
+                float u1, u2;
+                sample.sampler->get2D(sample.x, sample.y, sample.index * count + k, dimension, u1, u2);
+                LightSample lightSample = light->sample(record.point, u1, u2);
                 
-                // Parâmetros ajustados para corresponder melhor à iluminação suave da referência
-                float attenuation = 1.0f / (1.0f + 0.09f * distance + 0.032f * distance * distance);
+                // Verificar sombra com o mesmo ponto da luz
+                if (scene.isShadowed(record.point, lightSample)) continue;
                 
-                // Ajustar intensidade da luz conforme a atenuação
-                Color adjustedIntensity = lightIntensity * attenuation;
+                float attenuation = lightAttenuation(lightSample.distance);
                 
                 // Adicionar iluminação usando o modelo Phong
-                color += record.material->shade(ray, record, lightDir, adjustedIntensity);
+                sum += record.material->shade(ray, record, lightSample.direction, lightSample.intensity * attenuation);
             }
+            
+            color += sum * (1.0f / float(count));
         }
         
         return color;
     }
     
-    // Número aleatório entre 0 e 1 com melhor distribuição
-    float randomFloat() {
-        return dist(gen);
+    // Iluminação direta das lanes de "mask" de um pacote de raios primários,
+    // com as mesmas amostras de luz da versão escalar (profundidade 0). Os
+    // raios de sombra de cada amostra de luz formam um pacote, e o modelo de
+    // Phong é avaliado de uma vez para todas as lanes de um mesmo material.
+    void calculateDirectLight(const RayPacket& packet, const Scene& scene, const HitRecord* records,
+                              const PacketMask& mask, const PixelSample* samples, Color* out) const {
+        Vector3 points[PacketSize], normals[PacketSize];
+        Color ambient[PacketSize];
+        const Material* materials[PacketSize];
+        for (int lane = 0; lane < PacketSize; lane++) {
+            bool hit = (mask.bits() >> lane) & 1u;
+            points[lane] = hit ? records[lane].point : Vector3(0, 0, 0);
+            normals[lane] = hit ? records[lane].normal : Vector3(0, 0, 0);
+            materials[lane] = hit ? records[lane].material : nullptr;
+            ambient[lane] = hit ? scene.ambientLight.intensity * materials[lane]->ambient : Color(0, 0, 0);
+        }
+        PacketVec3 point = PacketVec3::load(points);
+        PacketVec3 normal = PacketVec3::load(normals);
+        PacketColor color = PacketColor::load(ambient);
+        
+        uint32_t dimension = 2;
+        for (size_t l = 0; l < scene.lights.size(); l++, dimension += 2) {
+            const Light* light = scene.lights[l];
+            int count = light->sampleCount();
+            PacketColor sum;
+            
+            for (int k = 0; k < count; k++) {
+                Vector3 directions[PacketSize];
+                float distances[PacketSize] = {0.0f};
+                Color intensities[PacketSize];
+                for (unsigned int bits = mask.bits(); bits; bits &= bits - 1) {
+                    int lane = lowestLane(bits);
+                    const PixelSample& sample = samples[lane];
+                    float u1, u2;
+                    sample.sampler->get2D(sample.x, sample.y, sample.index * count + k, dimension, u1, u2);
+                    LightSample lightSample = light->sample(points[lane], u1, u2);
+                    directions[lane] = lightSample.direction;
+                    distances[lane] = lightSample.distance;
+                    intensities[lane] = lightSample.intensity;
+                }
+                PacketVec3 lightDir = PacketVec3::load(directions);
+                PacketFloat distance = PacketFloat::load(distances);
+                
+                PacketMask lit = mask & !scene.isShadowed(point, lightDir, distance, mask);
+                if (lit.none()) continue;
+                
+                PacketFloat attenuation = PacketFloat(1.0f) /
+                    (PacketFloat(1.0f) + PacketFloat(0.09f) * distance + PacketFloat(0.032f) * distance * distance);
+                PacketColor intensity = PacketColor::load(intensities) * attenuation;
+                
+                // Lanes agrupadas por material
+                for (unsigned int pending = lit.bits(); pending;) {
+                    const Material* material = materials[lowestLane(pending)];
+                    unsigned int group = 0;
+                    for (unsigned int bits = pending; bits; bits &= bits - 1) {
+                        int lane = lowestLane(bits);
+                        if (materials[lane] == material) group |= 1u << lane;
+                    }
+                    sum += select(PacketMask::fromBits(group),
+                                  material->shade(packet.direction, normal, lightDir, intensity), PacketColor());
+                    pending &= ~group;
+                }
+            }
+            
+            color += sum * PacketFloat(1.0f / float(count));
+        }
+        
+        for (int lane = 0; lane < PacketSize; lane++) out[lane] = color.get(lane);
+    }
+    
+    static int maxThreads() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+    
+    static int threadIndex() {
+#ifdef _OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
     }
 };
 
@@ -0,0 +1,274 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Vetores de N floats (vfloat<N>) e máscaras de N lanes (vbool<N>) com as
+// operações usadas nos pacotes de raios. A largura nativa SimdWidth é
+// escolhida na compilação: 16 com AVX-512, 8 com AVX, 4 com SSE. As larguras
+// sem suporte do processador usam a implementação genérica em laços
+// escalares, que o compilador pode vetorizar por conta própria.
+#if defined(__AVX512F__)
+static const int SimdWidth = 16;
+#elif defined(__AVX__)
+static const int SimdWidth = 8;
+#else
+static const int SimdWidth = 4;
+#endif
+
+// Índice da primeira lane ativa de uma máscara (bits != 0)
+inline int lowestLane(unsigned int bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(bits);
+#else
+    int lane = 0;
+    while (!((bits >> lane) & 1u)) lane++;
+    return lane;
+#endif
+}
+
+// Implementação genérica: máscara como bits, valores em um array
+template <int N>
+struct vbool {
+    unsigned int mask;
+
+    vbool() : mask(0) {}
+    explicit vbool(bool b) : mask(b ? allBits() : 0u) {}
+
+    static vbool fromBits(unsigned int bits) { vbool r; r.mask = bits & allBits(); return r; }
+    unsigned int bits() const { return mask; }
+    bool any() const { return mask != 0; }
+    bool all() const { return mask == allBits(); }
+    bool none() const { return mask == 0; }
+
+    vbool operator&(const vbool& b) const { return fromBits(mask & b.mask); }
+    vbool operator|(const vbool& b) const { return fromBits(mask | b.mask); }
+    vbool operator!() const { return fromBits(~mask); }
+
+private:
+    static unsigned int allBits() { return N >= 32 ? ~0u : (1u << N) - 1u; }
+};
+
+template <int N>
+struct vfloat {
+    alignas(sizeof(float) * N) float v[N];
+
+    vfloat() {}
+    vfloat(float s) { for (int i = 0; i < N; i++) v[i] = s; }
+
+    static vfloat load(const float* p) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = p[i]; return r; }
+    // Converte N bytes sem sinal (0 a 255) em floats
+    static vfloat loadBytes(const unsigned char* p) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = p[i]; return r; }
+    void store(float* p) const { for (int i = 0; i < N; i++) p[i] = v[i]; }
+    float operator[](int i) const { return v[i]; }
+
+    friend vfloat operator+(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] + b.v[i]; return r; }
+    friend vfloat operator-(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] - b.v[i]; return r; }
+    friend vfloat operator*(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] * b.v[i]; return r; }
+    friend vfloat operator/(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] / b.v[i]; return r; }
+    vfloat operator-() const { vfloat r; for (int i = 0; i < N; i++) r.v[i] = -v[i]; return r; }
+
+    friend vbool<N> operator<(const vfloat& a, const vfloat& b) { unsigned int m = 0; for (int i = 0; i < N; i++) m |= (a.v[i] < b.v[i] ? 1u : 0u) << i; return vbool<N>::fromBits(m); }
+    friend vbool<N> operator<=(const vfloat& a, const vfloat& b) { unsigned int m = 0; for (int i = 0; i < N; i++) m |= (a.v[i] <= b.v[i] ? 1u : 0u) << i; return vbool<N>::fromBits(m); }
+    friend vbool<N> operator>(const vfloat& a, const vfloat& b) { return b < a; }
+    friend vbool<N> operator>=(const vfloat& a, const vfloat& b) { return b <= a; }
+
+    // Mesma semântica das instruções minps/maxps: com NaN, retorna o segundo operando
+    friend vfloat min(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r; }
+    friend vfloat max(const vfloat& a, const vfloat& b) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r; }
+    friend vfloat sqrt(const vfloat& a) { vfloat r; for (int i = 0; i < N; i++) r.v[i] = std::sqrt(a.v[i]); return r; }
+
+    // m ? a : b, lane a lane
+    friend vfloat select(const vbool<N>& m, const vfloat& a, const vfloat& b) {
+        vfloat r;
+        for (int i = 0; i < N; i++) r.v[i] = (m.bits() >> i) & 1u ? a.v[i] : b.v[i];
+        return r;
+    }
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+// SSE: 4 lanes
+template <>
+struct vbool<4> {
+    __m128 m;
+
+    vbool() : m(_mm_setzero_ps()) {}
+    explicit vbool(bool b) : m(_mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0))) {}
+    explicit vbool(__m128 m) : m(m) {}
+
+    static vbool fromBits(unsigned int bits) {
+        __m128i lanes = _mm_set_epi32(8, 4, 2, 1);
+        __m128i b = _mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes);
+        return vbool(_mm_castsi128_ps(_mm_cmpeq_epi32(b, lanes)));
+    }
+    unsigned int bits() const { return static_cast<unsigned int>(_mm_movemask_ps(m)); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xf; }
+    bool none() const { return bits() == 0; }
+
+    vbool operator&(const vbool& b) const { return vbool(_mm_and_ps(m, b.m)); }
+    vbool operator|(const vbool& b) const { return vbool(_mm_or_ps(m, b.m)); }
+    vbool operator!() const { return vbool(_mm_xor_ps(m, _mm_castsi128_ps(_mm_set1_epi32(-1)))); }
+};
+
+template <>
+struct vfloat<4> {
+    __m128 v;
+
+    vfloat() {}
+    vfloat(float s) : v(_mm_set1_ps(s)) {}
+    vfloat(__m128 v) : v(v) {}
+
+    static vfloat load(const float* p) { return vfloat(_mm_loadu_ps(p)); }
+    static vfloat loadBytes(const unsigned char* p) {
+#if defined(__SSE4_1__)
+        int packed;
+        std::memcpy(&packed, p, sizeof(packed));
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+#else
+        return _mm_set_ps(p[3], p[2], p[1], p[0]);
+#endif
+    }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    float operator[](int i) const { float t[4]; store(t); return t[i]; }
+
+    friend vfloat operator+(const vfloat& a, const vfloat& b) { return _mm_add_ps(a.v, b.v); }
+    friend vfloat operator-(const vfloat& a, const vfloat& b) { return _mm_sub_ps(a.v, b.v); }
+    friend vfloat operator*(const vfloat& a, const vfloat& b) { return _mm_mul_ps(a.v, b.v); }
+    friend vfloat operator/(const vfloat& a, const vfloat& b) { return _mm_div_ps(a.v, b.v); }
+    vfloat operator-() const { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+
+    friend vbool<4> operator<(const vfloat& a, const vfloat& b) { return vbool<4>(_mm_cmplt_ps(a.v, b.v)); }
+    friend vbool<4> operator<=(const vfloat& a, const vfloat& b) { return vbool<4>(_mm_cmple_ps(a.v, b.v)); }
+    friend vbool<4> operator>(const vfloat& a, const vfloat& b) { return vbool<4>(_mm_cmpgt_ps(a.v, b.v)); }
+    friend vbool<4> operator>=(const vfloat& a, const vfloat& b) { return vbool<4>(_mm_cmpge_ps(a.v, b.v)); }
+
+    friend vfloat min(const vfloat& a, const vfloat& b) { return _mm_min_ps(a.v, b.v); }
+    friend vfloat max(const vfloat& a, const vfloat& b) { return _mm_max_ps(a.v, b.v); }
+    friend vfloat sqrt(const vfloat& a) { return _mm_sqrt_ps(a.v); }
+
+    friend vfloat select(const vbool<4>& m, const vfloat& a, const vfloat& b) {
+        return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v));
+    }
+};
+#endif
+
+#if defined(__AVX__)
+// AVX: 8 lanes
+template <>
+struct vbool<8> {
+    __m256 m;
+
+    vbool() : m(_mm256_setzero_ps()) {}
+    explicit vbool(bool b) : m(_mm256_castsi256_ps(_mm256_set1_epi32(b ? -1 : 0))) {}
+    explicit vbool(__m256 m) : m(m) {}
+
+    static vbool fromBits(unsigned int bits) {
+        // Cada lane testa o seu bit (comparação em ponto flutuante, disponível no AVX)
+        __m256 lanes = _mm256_castsi256_ps(_mm256_set_epi32(128, 64, 32, 16, 8, 4, 2, 1));
+        __m256 b = _mm256_and_ps(_mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(bits))), lanes);
+        return vbool(_mm256_cmp_ps(b, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+    }
+    unsigned int bits() const { return static_cast<unsigned int>(_mm256_movemask_ps(m)); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xff; }
+    bool none() const { return bits() == 0; }
+
+    vbool operator&(const vbool& b) const { return vbool(_mm256_and_ps(m, b.m)); }
+    vbool operator|(const vbool& b) const { return vbool(_mm256_or_ps(m, b.m)); }
+    vbool operator!() const { return vbool(_mm256_xor_ps(m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))); }
+};
+
+template <>
+struct vfloat<8> {
+    __m256 v;
+
+    vfloat() {}
+    vfloat(float s) : v(_mm256_set1_ps(s)) {}
+    vfloat(__m256 v) : v(v) {}
+
+    static vfloat load(const float* p) { return vfloat(_mm256_loadu_ps(p)); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+    float operator[](int i) const { float t[8]; store(t); return t[i]; }
+
+    friend vfloat operator+(const vfloat& a, const vfloat& b) { return _mm256_add_ps(a.v, b.v); }
+    friend vfloat operator-(const vfloat& a, const vfloat& b) { return _mm256_sub_ps(a.v, b.v); }
+    friend vfloat operator*(const vfloat& a, const vfloat& b) { return _mm256_mul_ps(a.v, b.v); }
+    friend vfloat operator/(const vfloat& a, const vfloat& b) { return _mm256_div_ps(a.v, b.v); }
+    vfloat operator-() const { return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f)); }
+
+    friend vbool<8> operator<(const vfloat& a, const vfloat& b) { return vbool<8>(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+    friend vbool<8> operator<=(const vfloat& a, const vfloat& b) { return vbool<8>(_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)); }
+    friend vbool<8> operator>(const vfloat& a, const vfloat& b) { return vbool<8>(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)); }
+    friend vbool<8> operator>=(const vfloat& a, const vfloat& b) { return vbool<8>(_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)); }
+
+    friend vfloat min(const vfloat& a, const vfloat& b) { return _mm256_min_ps(a.v, b.v); }
+    friend vfloat max(const vfloat& a, const vfloat& b) { return _mm256_max_ps(a.v, b.v); }
+    friend vfloat sqrt(const vfloat& a) { return _mm256_sqrt_ps(a.v); }
+
+    friend vfloat select(const vbool<8>& m, const vfloat& a, const vfloat& b) {
+        return _mm256_blendv_ps(b.v, a.v, m.m);
+    }
+};
+#endif
+
+#if defined(__AVX512F__)
+// AVX-512: 16 lanes, máscaras em registradores k
+template <>
+struct vbool<16> {
+    __mmask16 m;
+
+    vbool() : m(0) {}
+    explicit vbool(bool b) : m(b ? 0xffff : 0) {}
+
+    static vbool fromBits(unsigned int bits) { vbool r; r.m = static_cast<__mmask16>(bits); return r; }
+    unsigned int bits() const { return m; }
+    bool any() const { return m != 0; }
+    bool all() const { return m == 0xffff; }
+    bool none() const { return m == 0; }
+
+    vbool operator&(const vbool& b) const { return fromBits(m & b.m); }
+    vbool operator|(const vbool& b) const { return fromBits(m | b.m); }
+    vbool operator!() const { return fromBits(~m & 0xffffu); }
+};
+
+template <>
+struct vfloat<16> {
+    __m512 v;
+
+    vfloat() {}
+    vfloat(float s) : v(_mm512_set1_ps(s)) {}
+    vfloat(__m512 v) : v(v) {}
+
+    static vfloat load(const float* p) { return vfloat(_mm512_loadu_ps(p)); }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+    float operator[](int i) const { float t[16]; store(t); return t[i]; }
+
+    friend vfloat operator+(const vfloat& a, const vfloat& b) { return _mm512_add_ps(a.v, b.v); }
+    friend vfloat operator-(const vfloat& a, const vfloat& b) { return _mm512_sub_ps(a.v, b.v); }
+    friend vfloat operator*(const vfloat& a, const vfloat& b) { return _mm512_mul_ps(a.v, b.v); }
+    friend vfloat operator/(const vfloat& a, const vfloat& b) { return _mm512_div_ps(a.v, b.v); }
+    vfloat operator-() const { return _mm512_sub_ps(_mm512_setzero_ps(), v); }
+
+    friend vbool<16> operator<(const vfloat& a, const vfloat& b) { return vbool<16>::fromBits(_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)); }
+    friend vbool<16> operator<=(const vfloat& a, const vfloat& b) { return vbool<16>::fromBits(_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)); }
+    friend vbool<16> operator>(const vfloat& a, const vfloat& b) { return vbool<16>::fromBits(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)); }
+    friend vbool<16> operator>=(const vfloat& a, const vfloat& b) { return vbool<16>::fromBits(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)); }
+
+    friend vfloat min(const vfloat& a, const vfloat& b) { return _mm512_min_ps(a.v, b.v); }
+    friend vfloat max(const vfloat& a, const vfloat& b) { return _mm512_max_ps(a.v, b.v); }
+    friend vfloat sqrt(const vfloat& a) { return _mm512_sqrt_ps(a.v); }
+
+    friend vfloat select(const vbool<16>& m, const vfloat& a, const vfloat& b) {
+        return _mm512_mask_blend_ps(m.m, b.v, a.v);
+    }
+};
+#endif
+
+#endif // SIMD_H
@@ -0,0 +1,173 @@
+#ifndef TILE_SCHEDULER_H
+#define TILE_SCHEDULER_H
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+// Região retangular da imagem [x0, x1) x [y0, y1)
+struct Tile {
+    int x0, y0;
+    int x1, y1;
+
+    int pixelCount() const { return (x1 - x0) * (y1 - y0); }
+};
+
+// Ordem em que os tiles são percorridos
+enum class TileOrder {
+    Scanline,   // Linha a linha
+    Morton,     // Curva Z (Morton)
+    Hilbert     // Curva de Hilbert
+};
+
+// Distribui os tiles de uma imagem entre as threads com roubo de trabalho.
+// Os tiles são ordenados ao longo de uma curva de preenchimento do espaço e
+// divididos em blocos contíguos, um por thread. Cada thread consome o seu
+// bloco pela frente (preservando a localidade entre tiles vizinhos); quando
+// ele se esgota, rouba tiles do final do bloco de outra thread.
+class TileScheduler {
+public:
+    TileScheduler(int width, int height, int tileSize, TileOrder order, int numThreads)
+        : queues(std::max(1, numThreads)) {
+        tileSize = std::max(1, tileSize);
+        int tilesX = (width + tileSize - 1) / tileSize;
+        int tilesY = (height + tileSize - 1) / tileSize;
+
+        // Gerar os tiles com a chave da curva escolhida
+        std::vector<std::pair<uint64_t, Tile>> keyed;
+        keyed.reserve(tilesX * tilesY);
+        int gridSize = 1;
+        while (gridSize < tilesX || gridSize < tilesY) gridSize *= 2;
+
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                Tile tile;
+                tile.x0 = tx * tileSize;
+                tile.y0 = ty * tileSize;
+                tile.x1 = std::min(tile.x0 + tileSize, width);
+                tile.y1 = std::min(tile.y0 + tileSize, height);
+
+                uint64_t key;
+                switch (order) {
+                    case TileOrder::Morton:  key = mortonKey(tx, ty); break;
+                    case TileOrder::Hilbert: key = hilbertKey(gridSize, tx, ty); break;
+                    default:                 key = static_cast<uint64_t>(ty) * tilesX + tx; break;
+                }
+                keyed.push_back(std::make_pair(key, tile));
+            }
+        }
+
+        std::sort(keyed.begin(), keyed.end(),
+            [](const std::pair<uint64_t, Tile>& a, const std::pair<uint64_t, Tile>& b) {
+                return a.first < b.first;
+            });
+        tiles.reserve(keyed.size());
+        for (size_t i = 0; i < keyed.size(); i++) tiles.push_back(keyed[i].second);
+
+        // Um bloco contíguo da curva para cada thread
+        uint32_t n = static_cast<uint32_t>(tiles.size());
+        uint32_t threads = static_cast<uint32_t>(queues.size());
+        for (uint32_t t = 0; t < threads; t++) {
+            uint32_t head = static_cast<uint32_t>(uint64_t(n) * t / threads);
+            uint32_t tail = static_cast<uint32_t>(uint64_t(n) * (t + 1) / threads);
+            queues[t].range.store(pack(head, tail));
+        }
+    }
+
+    int tileCount() const { return static_cast<int>(tiles.size()); }
+
+    // Obtém o próximo tile para a thread. Retorna false quando não há mais trabalho.
+    bool next(int thread, Tile& tile) {
+        int threads = static_cast<int>(queues.size());
+        thread = thread % threads;
+
+        // Primeiro o próprio bloco, depois as demais threads em ordem circular
+        if (popFront(queues[thread], tile)) return true;
+        for (int i = 1; i < threads; i++) {
+            if (stealBack(queues[(thread + i) % threads], tile)) return true;
+        }
+        return false;
+    }
+
+private:
+    // Deque de uma thread: intervalo [head, tail) de "tiles" empacotado em
+    // 64 bits, atualizado com compare-and-swap. O preenchimento evita que
+    // deques de threads diferentes compartilhem a mesma linha de cache.
+    struct WorkQueue {
+        std::atomic<uint64_t> range;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+        WorkQueue() : range(0) {}
+        WorkQueue(const WorkQueue& other) : range(other.range.load()) {}
+    };
+
+    std::vector<Tile> tiles;
+    std::vector<WorkQueue> queues;
+
+    static uint64_t pack(uint32_t head, uint32_t tail) {
+        return (static_cast<uint64_t>(head) << 32) | tail;
+    }
+
+    bool popFront(WorkQueue& queue, Tile& tile) {
+        uint64_t range = queue.range.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t head = static_cast<uint32_t>(range >> 32);
+            uint32_t tail = static_cast<uint32_t>(range);
+            if (head >= tail) return false;
+            if (queue.range.compare_exchange_weak(range, pack(head + 1, tail))) {
+                tile = tiles[head];
+                return true;
+            }
+        }
+    }
+
+    bool stealBack(WorkQueue& queue, Tile& tile) {
+        uint64_t range = queue.range.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t head = static_cast<uint32_t>(range >> 32);
+            uint32_t tail = static_cast<uint32_t>(range);
+            if (head >= tail) return false;
+            if (queue.range.compare_exchange_weak(range, pack(head, tail - 1))) {
+                tile = tiles[tail - 1];
+                return true;
+            }
+        }
+    }
+
+    // Intercala os bits de x e y (curva Z)
+    static uint64_t mortonKey(uint32_t x, uint32_t y) {
+        return spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    static uint64_t spreadBits(uint64_t v) {
+        v &= 0xffffffffULL;
+        v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+        v = (v | (v << 8))  & 0x00ff00ff00ff00ffULL;
+        v = (v | (v << 4))  & 0x0f0f0f0f0f0f0f0fULL;
+        v = (v | (v << 2))  & 0x3333333333333333ULL;
+        v = (v | (v << 1))  & 0x5555555555555555ULL;
+        return v;
+    }
+
+    // Posição de (x, y) ao longo da curva de Hilbert numa grade n x n (n potência de 2)
+    static uint64_t hilbertKey(int n, int x, int y) {
+        uint64_t d = 0;
+        for (int s = n / 2; s > 0; s /= 2) {
+            int rx = (x & s) > 0;
+            int ry = (y & s) > 0;
+            d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+            // Rotacionar o quadrante
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+};
+
+#endif // TILE_SCHEDULER_H
@@ -0,0 +1,78 @@
+#ifndef VEC3X_H
+#define VEC3X_H
+
+#include "Simd.h"
+#include "Vector3.h"
+
+// N vetores 3D em layout SoA: as componentes x, y e z de todas as lanes
+// ficam em registradores separados, então cada operação de Vector3 vira
+// três instruções vetoriais. Larguras sem suporte do processador usam a
+// implementação genérica de vfloat.
+template <int N>
+struct Vec3x {
+    vfloat<N> x, y, z;
+
+    Vec3x() {}
+    Vec3x(const vfloat<N>& x, const vfloat<N>& y, const vfloat<N>& z) : x(x), y(y), z(z) {}
+
+    // O mesmo vetor em todas as lanes
+    explicit Vec3x(const Vector3& v) : x(v.x), y(v.y), z(v.z) {}
+
+    // Converte N vetores consecutivos (AoS) para SoA
+    static Vec3x load(const Vector3* v) {
+        float a[3][N];
+        for (int i = 0; i < N; i++) {
+            a[0][i] = v[i].x; a[1][i] = v[i].y; a[2][i] = v[i].z;
+        }
+        return Vec3x(vfloat<N>::load(a[0]), vfloat<N>::load(a[1]), vfloat<N>::load(a[2]));
+    }
+
+    // Vetor de uma lane
+    Vector3 get(int lane) const { return Vector3(x[lane], y[lane], z[lane]); }
+
+    Vec3x operator-() const { return Vec3x(-x, -y, -z); }
+    Vec3x operator+(const Vec3x& v) const { return Vec3x(x + v.x, y + v.y, z + v.z); }
+    Vec3x operator-(const Vec3x& v) const { return Vec3x(x - v.x, y - v.y, z - v.z); }
+    Vec3x operator*(const vfloat<N>& t) const { return Vec3x(x * t, y * t, z * t); }
+    Vec3x operator/(const vfloat<N>& t) const { vfloat<N> invT = vfloat<N>(1.0f) / t; return *this * invT; }
+
+    Vec3x& operator+=(const Vec3x& v) { x = x + v.x; y = y + v.y; z = z + v.z; return *this; }
+
+    vfloat<N> squaredLength() const { return x * x + y * y + z * z; }
+    vfloat<N> length() const { return sqrt(squaredLength()); }
+
+    // Como em Vector3::normalized, vetores nulos ficam inalterados
+    Vec3x normalized() const {
+        vfloat<N> len = length();
+        vbool<N> valid = len > vfloat<N>(0.0f);
+        vfloat<N> invLen = vfloat<N>(1.0f) / select(valid, len, vfloat<N>(1.0f));
+        return *this * invLen;
+    }
+};
+
+template <int N>
+inline vfloat<N> dot(const Vec3x<N>& a, const Vec3x<N>& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <int N>
+inline Vec3x<N> cross(const Vec3x<N>& a, const Vec3x<N>& b) {
+    return Vec3x<N>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+template <int N>
+inline Vec3x<N> normalize(const Vec3x<N>& v) {
+    return v.normalized();
+}
+
+// m ? a : b, lane a lane
+template <int N>
+inline Vec3x<N> select(const vbool<N>& m, const Vec3x<N>& a, const Vec3x<N>& b) {
+    return Vec3x<N>(select(m, a.x, b.x), select(m, a.y, b.y), select(m, a.z, b.z));
+}
+
+typedef Vec3x<4> Vec3x4;
+typedef Vec3x<8> Vec3x8;
+typedef Vec3x<16> Vec3x16;
+
+#endif // VEC3X_H
@@ -3,7 +3,7 @@
 
 #include <cmath>
 #include <iostream>
-#include <stdexcept>
+#include <type_traits>
 
 class Vector3 {
 public:
@@ -12,14 +12,8 @@ public:
     // Construtores
     Vector3() : x(0), y(0), z(0) {}
     Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
-    Vector3(const Vector3& v) : x(v.x), y(v.y), z(v.z) {}
 
-    // Operadores
-    Vector3& operator=(const Vector3& v) {
-        x = v.x; y = v.y; z = v.z;
-        return *this;
-    }
-    
+    // Operadores (cópia e atribuição implícitas: a classe é trivialmente copiável)
     Vector3 operator-() const { return Vector3(-x, -y, -z); }
     
     Vector3 operator+(const Vector3& v) const {
@@ -60,24 +54,11 @@ public:
         return *this;
     }
     
-    // Acesso por índice
-    float operator[](int i) const {
-        switch(i) {
-            case 0: return x;
-            case 1: return y;
-            case 2: return z;
-            default: throw std::out_of_range("Vector3 index out of range");
-        }
-    }
-    
-    float& operator[](int i) {
-        switch(i) {
-            case 0: return x;
-            case 1: return y;
-            case 2: return z;
-            default: throw std::out_of_range("Vector3 index out of range");
-        }
-    }
+    // Acesso por índice (0 = x, 1 = y, 2 = z), sem verificação de limites.
+    // Ternário em vez de (&x)[i], que seria indefinido além de x; vira cmov
+    // nos laços e some quando o índice é constante
+    float operator[](int i) const { return i == 0 ? x : (i == 1 ? y : z); }
+    float& operator[](int i) { return i == 0 ? x : (i == 1 ? y : z); }
     
     // Métodos de utilidade
     float length() const {
@@ -118,6 +99,9 @@ public:
     }
 };
 
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 deve conter apenas x, y e z");
+static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 deve ser trivialmente copiável");
+
 // Operadores externos
 inline Vector3 operator*(float t, const Vector3& v) {
     return v * t;
@@ -0,0 +1,279 @@
+#ifndef WAVEFRONT_INTEGRATOR_H
+#define WAVEFRONT_INTEGRATOR_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "Color.h"
+#include "RayPacket.h"
+#include "../geometry/Scene.h"
+#include "../material/MaterialKernels.h"
+#include "../sampler/Sampler.h"
+
+// Integrador em frentes de onda (wavefront): em vez de seguir um caminho
+// por vez até o fim, processa milhares de caminhos juntos, um estágio por
+// vez, com uma fila por estágio:
+//   1. geração: os raios primários recebidos formam a primeira fila;
+//   2. interseção: a fila é ordenada por octante da direção e posição da
+//      origem (curva de Morton) e traçada em pacotes SIMD;
+//   3. sombra: as amostras de luz de todos os pontos atingidos são
+//      agrupadas por luz e testadas em pacotes;
+//   4. sombreamento: as amostras visíveis são agrupadas por material e o
+//      modelo de Phong é avaliado em pacotes de um mesmo material;
+//   5. reflexão: o núcleo de espalhamento de cada material (MaterialKernels.h)
+//      gera a fila de raios da profundidade seguinte.
+// O resultado é o mesmo do Renderer::traceRay recursivo: cada nível soma
+// peso * (1 - refletividade) * luz direta e passa peso * refletividade ao
+// raio refletido (com diferenças apenas de arredondamento, pela ordem das somas).
+class WavefrontIntegrator {
+public:
+    // Caminhos processados de uma vez (limita a memória das filas)
+    static const int BatchSize = 4096;
+
+    // Caminho a partir de um raio primário; radiance e primary são a saída
+    struct Path {
+        Ray ray;
+        PixelSample sample;
+        Color radiance;
+        HitRecord primary;      // Interseção do raio primário (material nulo se não houver)
+    };
+
+    // Traça todos os caminhos até o fim, com profundidade máxima maxDepth
+    void trace(const Scene& scene, int maxDepth, std::vector<Path>& paths) {
+        rays.clear();
+        for (size_t p = 0; p < paths.size(); p++) {
+            paths[p].radiance = Color(0.0f, 0.0f, 0.0f);
+            paths[p].primary.material = nullptr;
+            RayItem item = {paths[p].ray, static_cast<int>(p), 0, Color(1.0f, 1.0f, 1.0f)};
+            if (maxDepth > 0) rays.push_back(item);
+        }
+
+        while (!rays.empty()) {
+            intersect(scene, paths);
+            traceShadows(scene, paths);
+            shade();
+            reflect(scene, maxDepth, paths);
+            rays.swap(nextRays);
+            nextRays.clear();
+        }
+    }
+
+private:
+    struct RayItem {
+        Ray ray;
+        int path;
+        int depth;
+        Color weight;       // Contribuição do raio para o pixel
+    };
+
+    struct HitItem {
+        RayItem ray;
+        HitRecord record;
+        int material;       // Posição do material em "materials"
+    };
+
+    struct ShadowItem {
+        int hit;
+        Vector3 direction;
+        float distance;
+        Color intensity;
+        bool visible;
+        Color contribution;
+    };
+
+    std::vector<RayItem> rays, nextRays;
+    std::vector<HitItem> hits;
+    std::vector<ShadowItem> shadows;        // Amostras de luz, agrupadas por luz
+    std::vector<int> lightOffsets;          // Primeira amostra de cada luz em "shadows"
+    std::vector<const Material*> materials; // Materiais distintos da fila atual
+    std::vector<uint64_t> keys;             // Chaves de ordenação da fila de raios
+    std::vector<int> materialCounts;        // Contagem (e depois início) por material
+    std::vector<int> order;
+
+    // Estágio de interseção: ordena a fila para agrupar raios coerentes e
+    // traça pacotes de PacketSize raios
+    void intersect(const Scene& scene, std::vector<Path>& paths) {
+        AABB bounds = scene.bounds();
+        if (bounds.isEmpty()) bounds = AABB(Vector3(0, 0, 0), Vector3(1, 1, 1));
+        // Chave nos 32 bits altos e posição na fila nos baixos: a ordenação é estável
+        keys.resize(rays.size());
+        for (size_t i = 0; i < rays.size(); i++) {
+            keys[i] = (static_cast<uint64_t>(sortKey(rays[i].ray, bounds)) << 32) | i;
+        }
+        std::sort(keys.begin(), keys.end());
+        order.resize(rays.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(keys[i] & 0xffffffffu);
+
+        const float tMin = 0.001f;
+        const float infinity = std::numeric_limits<float>::infinity();
+        hits.clear();
+        materials.clear();
+        Ray packetRays[PacketSize];
+        for (size_t first = 0; first < order.size(); first += PacketSize) {
+            int count = static_cast<int>(std::min<size_t>(PacketSize, order.size() - first));
+            for (int lane = 0; lane < count; lane++) packetRays[lane] = rays[order[first + lane]].ray;
+
+            RayPacket packet(packetRays, count);
+            PacketHit result(infinity);
+            scene.hitPacket(packet, tMin, result);
+
+            for (int lane = 0; lane < count; lane++) {
+                int object = result.primitive[lane];
+                if (object < 0) continue;
+                HitItem hit;
+                hit.ray = rays[order[first + lane]];
+                if (!scene.tracedObject(object)->hit(hit.ray.ray, tMin, infinity, hit.record)) continue;
+                if (hit.ray.depth == 0) paths[hit.ray.path].primary = hit.record;
+                hit.material = materialSlot(hit.record.material);
+                hits.push_back(hit);
+            }
+        }
+    }
+
+    // Estágio de sombra: gera as amostras de luz de todos os pontos (com os
+    // mesmos números do Sampler que a versão recursiva), luz por luz, e
+    // testa a visibilidade em pacotes de raios de sombra para a mesma luz
+    void traceShadows(const Scene& scene, const std::vector<Path>& paths) {
+        shadows.clear();
+        lightOffsets.resize(scene.lights.size());
+        for (size_t l = 0; l < scene.lights.size(); l++) {
+            const Light* light = scene.lights[l];
+            int count = light->sampleCount();
+            lightOffsets[l] = static_cast<int>(shadows.size());
+            for (size_t h = 0; h < hits.size(); h++) {
+                const HitItem& hit = hits[h];
+                const PixelSample& sample = paths[hit.ray.path].sample;
+                uint32_t dimension = 2 + 2 * static_cast<uint32_t>(hit.ray.depth * scene.lights.size() + l);
+                for (int k = 0; k < count; k++) {
+                    float u1, u2;
+                    sample.sampler->get2D(sample.x, sample.y, sample.index * count + k, dimension, u1, u2);
+                    LightSample lightSample = light->sample(hit.record.point, u1, u2);
+                    ShadowItem item;
+                    item.hit = static_cast<int>(h);
+                    item.direction = lightSample.direction;
+                    item.distance = lightSample.distance;
+                    item.intensity = lightSample.intensity;
+                    item.visible = false;
+                    shadows.push_back(item);
+                }
+            }
+        }
+
+        Vector3 points[PacketSize], directions[PacketSize];
+        float distances[PacketSize];
+        for (size_t first = 0; first < shadows.size(); first += PacketSize) {
+            int count = static_cast<int>(std::min<size_t>(PacketSize, shadows.size() - first));
+            for (int lane = 0; lane < PacketSize; lane++) {
+                const ShadowItem& item = shadows[first + std::min(lane, count - 1)];
+                points[lane] = hits[item.hit].record.point;
+                directions[lane] = item.direction;
+                distances[lane] = item.distance;
+            }
+            PacketMask mask = PacketMask::fromBits(count >= PacketSize ? ~0u : (1u << count) - 1u);
+            PacketMask blocked = scene.isShadowed(PacketVec3::load(points), PacketVec3::load(directions),
+                                                  PacketFloat::load(distances), mask);
+            for (int lane = 0; lane < count; lane++) {
+                shadows[first + lane].visible = !((blocked.bits() >> lane) & 1u);
+            }
+        }
+    }
+
+    // Estágio de sombreamento: amostras visíveis agrupadas por material
+    // (ordenação por contagem) e avaliadas em pacotes de um único material
+    void shade() {
+        materialCounts.assign(materials.size() + 1, 0);
+        for (size_t i = 0; i < shadows.size(); i++) {
+            if (shadows[i].visible) materialCounts[hits[shadows[i].hit].material + 1]++;
+        }
+        for (size_t m = 1; m < materialCounts.size(); m++) materialCounts[m] += materialCounts[m - 1];
+        order.resize(materialCounts.back());
+        for (size_t i = 0; i < shadows.size(); i++) {
+            if (shadows[i].visible) order[materialCounts[hits[shadows[i].hit].material]++] = static_cast<int>(i);
+        }
+
+        Vector3 rayDirections[PacketSize], normals[PacketSize], directions[PacketSize];
+        Color intensities[PacketSize];
+        size_t first = 0;
+        while (first < order.size()) {
+            int current = hits[shadows[order[first]].hit].material;
+            int count = 1;
+            while (count < PacketSize && first + count < order.size() &&
+                   hits[shadows[order[first + count]].hit].material == current) {
+                count++;
+            }
+            for (int lane = 0; lane < PacketSize; lane++) {
+                const ShadowItem& item = shadows[order[first + std::min(lane, count - 1)]];
+                const HitItem& hit = hits[item.hit];
+                rayDirections[lane] = hit.ray.ray.direction;
+                normals[lane] = hit.record.normal;
+                directions[lane] = item.direction;
+                intensities[lane] = item.intensity * lightAttenuation(item.distance);
+            }
+            PacketColor color = materials[current]->shade(PacketVec3::load(rayDirections), PacketVec3::load(normals),
+                                                          PacketVec3::load(directions), PacketColor::load(intensities));
+            for (int lane = 0; lane < count; lane++) {
+                shadows[order[first + lane]].contribution = color.get(lane);
+            }
+            first += count;
+        }
+    }
+
+    // Estágio de reflexão: soma a luz direta de cada ponto ao seu caminho
+    // e cria os raios refletidos da profundidade seguinte
+    void reflect(const Scene& scene, int maxDepth, std::vector<Path>& paths) {
+        for (size_t h = 0; h < hits.size(); h++) {
+            const HitItem& hit = hits[h];
+            const Material* surface = hit.record.material;
+
+            // Mesma ordem de soma de Renderer::calculateDirectLight
+            Color direct = scene.ambientLight.intensity * surface->ambient;
+            for (size_t l = 0; l < scene.lights.size(); l++) {
+                int count = scene.lights[l]->sampleCount();
+                const ShadowItem* samples = &shadows[lightOffsets[l] + h * count];
+                Color sum(0, 0, 0);
+                for (int k = 0; k < count; k++) {
+                    if (samples[k].visible) sum += samples[k].contribution;
+                }
+                direct += sum * (1.0f / float(count));
+            }
+
+            const PixelSample& sample = paths[hit.ray.path].sample;
+            Scatter next = scatter(*surface, hit.ray.ray, hit.record, sample.pathValue(hit.ray.depth, 0));
+            if (!next.hasRay) {
+                paths[hit.ray.path].radiance += direct * hit.ray.weight;
+                continue;
+            }
+            paths[hit.ray.path].radiance += direct * (hit.ray.weight * next.directWeight);
+            if (hit.ray.depth + 1 < maxDepth) {
+                RayItem item = {next.ray, hit.ray.path, hit.ray.depth + 1, hit.ray.weight * next.weight};
+                nextRays.push_back(item);
+            }
+        }
+    }
+
+    // Posição de um material em "materials" (poucos materiais por cena)
+    int materialSlot(const Material* material) {
+        for (size_t m = 0; m < materials.size(); m++) {
+            if (materials[m] == material) return static_cast<int>(m);
+        }
+        materials.push_back(material);
+        return static_cast<int>(materials.size() - 1);
+    }
+
+    // Octante da direção nos 3 bits mais altos, seguido do código de Morton
+    // da origem (9 bits por eixo) dentro da caixa da cena
+    static uint32_t sortKey(const Ray& ray, const AABB& bounds) {
+        uint32_t octant = (ray.direction.x < 0.0f ? 1u : 0u) | (ray.direction.y < 0.0f ? 2u : 0u) |
+                          (ray.direction.z < 0.0f ? 4u : 0u);
+        Vector3 extent = bounds.extent();
+        uint32_t morton = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            float t = extent[axis] > 0.0f ? (ray.origin[axis] - bounds.min[axis]) / extent[axis] : 0.0f;
+            uint32_t q = static_cast<uint32_t>(std::min(std::max(t, 0.0f), 1.0f) * 511.0f);
+            for (int bit = 0; bit < 9; bit++) morton |= ((q >> bit) & 1u) << (3 * bit + axis);
+        }
+        return (octant << 29) | morton;
+    }
+};
+
+#endif // WAVEFRONT_INTEGRATOR_H
@@ -0,0 +1,130 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <limits>
+#include <algorithm>
+#include "../core/Vector3.h"
+#include "../core/Ray.h"
+#include "../core/AffineMatrix.h"
+
+// Caixa delimitadora alinhada aos eixos (axis-aligned bounding box)
+class AABB {
+public:
+    Vector3 min;    // Canto mínimo
+    Vector3 max;    // Canto máximo
+
+    // Construtor padrão: caixa vazia (min = +inf, max = -inf)
+    AABB()
+        : min(std::numeric_limits<float>::infinity(),
+              std::numeric_limits<float>::infinity(),
+              std::numeric_limits<float>::infinity()),
+          max(-std::numeric_limits<float>::infinity(),
+              -std::numeric_limits<float>::infinity(),
+              -std::numeric_limits<float>::infinity()) {}
+
+    AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {}
+
+    // Expande a caixa para conter um ponto
+    void expand(const Vector3& p) {
+        min = Vector3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+        max = Vector3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+    }
+
+    // Expande a caixa para conter outra caixa
+    void expand(const AABB& b) {
+        min = Vector3(std::min(min.x, b.min.x), std::min(min.y, b.min.y), std::min(min.z, b.min.z));
+        max = Vector3(std::max(max.x, b.max.x), std::max(max.y, b.max.y), std::max(max.z, b.max.z));
+    }
+
+    bool isEmpty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    Vector3 centroid() const {
+        return (min + max) * 0.5f;
+    }
+
+    Vector3 extent() const {
+        return max - min;
+    }
+
+    // Área da superfície, usada pela heurística de área de superfície (SAH)
+    float surfaceArea() const {
+        if (isEmpty()) return 0.0f;
+        Vector3 d = extent();
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Menor caixa alinhada aos eixos que contém esta caixa transformada por m
+    // (cada eixo de saída soma o menor e o maior termo de cada coluna)
+    AABB transformed(const AffineMatrix& m) const {
+        if (isEmpty()) return *this;
+        AABB result(m.translation, m.translation);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                float a = m.rows[i][j] * min[j];
+                float b = m.rows[i][j] * max[j];
+                result.min[i] += std::min(a, b);
+                result.max[i] += std::max(a, b);
+            }
+        }
+        return result;
+    }
+
+    // Eixo de maior extensão (0 = x, 1 = y, 2 = z)
+    int longestAxis() const {
+        Vector3 d = extent();
+        if (d.x > d.y && d.x > d.z) return 0;
+        return d.y > d.z ? 1 : 2;
+    }
+
+    // Teste de interseção raio-caixa pelo método dos slabs.
+    // invDir é o inverso da direção do raio, pré-calculado pelo chamador.
+    // As comparações na forma "a > b ? a : b" descartam NaN (origem sobre um
+    // plano da caixa com componente nula na direção) sem rejeitar o raio.
+    bool hit(const Ray& ray, const Vector3& invDir, float tMin, float tMax, float& tEntry) const {
+        float t1 = (min.x - ray.origin.x) * invDir.x;
+        float t2 = (max.x - ray.origin.x) * invDir.x;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = t1 > tMin ? t1 : tMin;
+        tMax = t2 < tMax ? t2 : tMax;
+
+        t1 = (min.y - ray.origin.y) * invDir.y;
+        t2 = (max.y - ray.origin.y) * invDir.y;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = t1 > tMin ? t1 : tMin;
+        tMax = t2 < tMax ? t2 : tMax;
+
+        t1 = (min.z - ray.origin.z) * invDir.z;
+        t2 = (max.z - ray.origin.z) * invDir.z;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = t1 > tMin ? t1 : tMin;
+        tMax = t2 < tMax ? t2 : tMax;
+
+        tEntry = tMin;
+        return tMin <= tMax;
+    }
+
+    // Mesmo teste de hit, reduzindo [tMin, tMax] ao trecho do raio dentro
+    // da caixa (entrada e saída), usado pelas estruturas que percorrem
+    // células ou semiespaços ao longo do raio
+    bool clip(const Ray& ray, const Vector3& invDir, float& tMin, float& tMax) const {
+        for (int axis = 0; axis < 3; axis++) {
+            float t1 = (min[axis] - ray.origin[axis]) * invDir[axis];
+            float t2 = (max[axis] - ray.origin[axis]) * invDir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = t1 > tMin ? t1 : tMin;
+            tMax = t2 < tMax ? t2 : tMax;
+        }
+        return tMin <= tMax;
+    }
+};
+
+// União de duas caixas
+inline AABB surroundingBox(const AABB& a, const AABB& b) {
+    AABB box = a;
+    box.expand(b);
+    return box;
+}
+
+#endif // AABB_H
@@ -65,6 +65,62 @@ public:
         
         return true;
     }
+
+    // Teste dos slabs sem rastrear o eixo atingido nem calcular a normal
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        float tNear = tMin, tFar = tMax;
+        
+        for (int i = 0; i < 3; i++) {
+            float invD = 1.0f / ray.direction[i];
+            float t1 = (min[i] - ray.origin[i]) * invD;
+            float t2 = (max[i] - ray.origin[i]) * invD;
+            if (invD < 0.0f) std::swap(t1, t2);
+            
+            if (t1 > tNear) tNear = t1;
+            if (t2 < tFar) tFar = t2;
+            if (tNear > tFar) return false;
+        }
+        
+        return true;
+    }
+
+    // Teste dos slabs para um pacote de raios, com a mesma distância de entrada que hit
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        PacketFloat tNear(tMin), tFar = result.t;
+        slab(min.x, max.x, packet.origin.x, packet.invDirection.x, tNear, tFar);
+        slab(min.y, max.y, packet.origin.y, packet.invDirection.y, tNear, tFar);
+        slab(min.z, max.z, packet.origin.z, packet.invDirection.z, tNear, tFar);
+        result.update(mask & (tNear <= tFar), tNear, index);
+    }
+
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        PacketFloat tNear(tMin), tFar = tMax;
+        slab(min.x, max.x, packet.origin.x, packet.invDirection.x, tNear, tFar);
+        slab(min.y, max.y, packet.origin.y, packet.invDirection.y, tNear, tFar);
+        slab(min.z, max.z, packet.origin.z, packet.invDirection.z, tNear, tFar);
+        return mask & (tNear <= tFar);
+    }
+
+    virtual AABB boundingBox() const override {
+        return AABB(min, max);
+    }
+
+    virtual Material* getMaterial() const override { return material; }
+
+private:
+    // Restringe [tNear, tFar] ao slab de um eixo. As comparações descartam
+    // NaN (origem sobre o plano e direção paralela a ele) como em hit.
+    static void slab(float lo, float hi, const PacketFloat& origin, const PacketFloat& invDir,
+                     PacketFloat& tNear, PacketFloat& tFar) {
+        PacketFloat t1 = (PacketFloat(lo) - origin) * invDir;
+        PacketFloat t2 = (PacketFloat(hi) - origin) * invDir;
+        PacketFloat tEnter = select(t1 < t2, t1, t2);
+        PacketFloat tExit = select(t1 < t2, t2, t1);
+        tNear = select(tEnter > tNear, tEnter, tNear);
+        tFar = select(tExit < tFar, tExit, tFar);
+    }
 };
 
 #endif // BOX_H 
\ No newline at end of file
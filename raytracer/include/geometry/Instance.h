@@ -0,0 +1,86 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <memory>
+#include "Primitive.h"
+#include "../accel/BLAS.h"
+#include "../core/AffineMatrix.h"
+#include "../transform/Transform.h"
+
+// Cópia de uma BLAS posicionada na cena por uma transformação afim. Os raios
+// são levados ao espaço do objeto com uma única matriz e testados contra a
+// BVH compartilhada; a caixa no espaço do mundo é calculada uma vez, então a
+// BVH da cena só entrega à instância os raios que passam perto dela.
+// Milhares de instâncias de uma malha custam uma matriz e uma caixa cada.
+class Instance : public Primitive {
+public:
+    std::shared_ptr<const BLAS> geometry;
+    AffineMatrix toWorld;       // Espaço do objeto para o espaço do mundo
+    AffineMatrix toObject;      // Inversa de toWorld
+    Material* material;         // Se não for nulo, substitui o material das primitivas
+    AABB bounds;                // Caixa no espaço do mundo
+
+    Instance(const std::shared_ptr<const BLAS>& geometry, const AffineMatrix& toWorld, Material* material = nullptr)
+        : geometry(geometry), toWorld(toWorld), toObject(toWorld.inverse()), material(material),
+          bounds(geometry->bounds().transformed(toWorld)) {}
+
+    // Move a instância (animação): a BLAS não muda, só as matrizes e a caixa
+    void setTransform(const AffineMatrix& matrix) {
+        toWorld = matrix;
+        toObject = matrix.inverse();
+        bounds = geometry->bounds().transformed(matrix);
+    }
+
+    // Reduz uma cadeia de transformações (por exemplo Translate(Rotate(Box)))
+    // a uma instância com a matriz composta e uma BLAS com o objeto final
+    static Instance* flatten(Primitive* object, Material* material = nullptr) {
+        AffineMatrix toWorld = Transform::composeChain(object);
+        std::shared_ptr<BLAS> geometry = std::make_shared<BLAS>();
+        geometry->add(object);
+        geometry->build();
+        return new Instance(geometry, toWorld, material);
+    }
+
+    virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
+        if (!geometry->hit(localRay(ray), tMin, tMax, record)) return false;
+
+        // A inversa transposta preserva o lado da normal em relação ao raio
+        record.point = toWorld.transformPoint(record.point);
+        record.normal = normalize(toObject.transformTransposed(record.normal));
+        if (material) record.material = material;
+        return true;
+    }
+
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        return geometry->occluded(localRay(ray), tMin, tMax);
+    }
+
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        geometry->hitPacket(localPacket(packet, mask), tMin, result, index);
+    }
+
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        return geometry->occludedPacket(localPacket(packet, mask), tMin, tMax);
+    }
+
+    virtual AABB boundingBox() const override { return bounds; }
+
+    // Material único da instância (ou da primitiva, se a BLAS tiver só uma)
+    virtual Material* getMaterial() const override {
+        if (material) return material;
+        return geometry->objects.size() == 1 ? geometry->objects[0]->getMaterial() : nullptr;
+    }
+
+private:
+    Ray localRay(const Ray& ray) const {
+        return Ray(toObject.transformPoint(ray.origin), toObject.transformVector(ray.direction));
+    }
+
+    RayPacket localPacket(const RayPacket& packet, const PacketMask& mask) const {
+        return RayPacket(toObject.transformPoint(packet.origin), toObject.transformVector(packet.direction), mask);
+    }
+};
+
+#endif // INSTANCE_H
@@ -0,0 +1,185 @@
+#ifndef ORIENTED_BOX_H
+#define ORIENTED_BOX_H
+
+#include <limits>
+#include "Primitive.h"
+#include "../core/AffineMatrix.h"
+
+// Caixa com orientação arbitrária: centro, três eixos ortonormais e meia
+// extensão ao longo de cada eixo. Substitui Translate(Rotate(Box)) por uma
+// única primitiva: o raio é projetado nos eixos pré-calculados e o teste dos
+// slabs não tem desvios (mínimos e máximos), sem chamadas virtuais
+// intermediárias nem transformação do registro de interseção.
+class OrientedBox : public Primitive {
+public:
+    Vector3 center;
+    Vector3 axes[3];            // Eixos locais no espaço do mundo (ortonormais, ver orthonormalize)
+    Vector3 halfExtents;        // Meia extensão ao longo de cada eixo
+    Vector3 invHalfExtents;     // Inverso de cada meia extensão (escolha da face atingida)
+    Material* material;
+
+    // Eixos não ortogonais são ortonormalizados (ver orthonormalize)
+    OrientedBox(const Vector3& center, const Vector3& halfExtents, const Vector3& axisX, const Vector3& axisY,
+                const Vector3& axisZ, Material* material)
+        : center(center), halfExtents(halfExtents), material(material) {
+        Vector3 columns[3] = {axisX, axisY, axisZ};
+        orthonormalize(columns);
+        computeInverse();
+    }
+
+    // A caixa [min, max] levada ao espaço do mundo por "toWorld" (rotações,
+    // translações e escalas por eixo). Equivale a Translate(Rotate(Box(min,
+    // max))) com toWorld = translate * rotate. Uma parte linear com
+    // cisalhamento (colunas não ortogonais) não é representável: ela é
+    // ortonormalizada, e a meia extensão de cada eixo é a projeção da
+    // coluna sobre ele, sem aviso.
+    OrientedBox(const Vector3& min, const Vector3& max, const AffineMatrix& toWorld, Material* material)
+        : center(toWorld.transformPoint((min + max) * 0.5f)), material(material) {
+        Vector3 half = (max - min) * 0.5f;
+        // Coluna i da parte linear: imagem do eixo local i
+        Vector3 columns[3];
+        for (int i = 0; i < 3; i++) {
+            columns[i] = Vector3(toWorld.rows[0][i], toWorld.rows[1][i], toWorld.rows[2][i]);
+        }
+        orthonormalize(columns);
+        for (int i = 0; i < 3; i++) halfExtents[i] = half[i] * std::fabs(dot(columns[i], axes[i]));
+        computeInverse();
+    }
+
+    virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
+        Ray local = localRay(ray);
+        Vector3 invDir(1.0f / local.direction.x, 1.0f / local.direction.y, 1.0f / local.direction.z);
+        float tEnter, tExit;
+        slabs(local.origin, invDir, tEnter, tExit);
+        if (!(tEnter <= tExit)) return false;
+
+        // Com a origem dentro da caixa, a interseção é a saída
+        float t = tEnter >= tMin ? tEnter : tExit;
+        if (t < tMin || t > tMax) return false;
+
+        // Face atingida: eixo em que o ponto local está mais perto da meia extensão
+        Vector3 point = local.pointAtParameter(t);
+        float d0 = std::fabs(point.x) * invHalfExtents.x;
+        float d1 = std::fabs(point.y) * invHalfExtents.y;
+        float d2 = std::fabs(point.z) * invHalfExtents.z;
+        int axis = d0 > d1 ? (d0 > d2 ? 0 : 2) : (d1 > d2 ? 1 : 2);
+
+        record.t = t;
+        record.point = ray.pointAtParameter(t);
+        record.setFaceNormal(ray, point[axis] < 0.0f ? -axes[axis] : axes[axis]);
+        record.material = material;
+        return true;
+    }
+
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        Ray local = localRay(ray);
+        Vector3 invDir(1.0f / local.direction.x, 1.0f / local.direction.y, 1.0f / local.direction.z);
+        float tEnter, tExit;
+        slabs(local.origin, invDir, tEnter, tExit);
+        return std::max(tEnter, tMin) <= std::min(tExit, tMax);
+    }
+
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        PacketFloat tEnter, tExit;
+        slabs(localPacket(packet, mask), tEnter, tExit);
+        PacketFloat lower(tMin);
+        PacketFloat t = select(tEnter >= lower, tEnter, tExit);
+        result.update(mask & (tEnter <= tExit) & (t >= lower) & (t <= result.t), t, index);
+    }
+
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        PacketFloat tEnter, tExit;
+        slabs(localPacket(packet, mask), tEnter, tExit);
+        PacketFloat lower(tMin);
+        PacketFloat tNear = select(tEnter > lower, tEnter, lower);
+        PacketFloat tFar = select(tExit < tMax, tExit, tMax);
+        return mask & (tNear <= tFar);
+    }
+
+    // Caixa alinhada aos eixos justa: soma das projeções dos três eixos
+    virtual AABB boundingBox() const override {
+        Vector3 reach(0, 0, 0);
+        for (int i = 0; i < 3; i++) {
+            reach += Vector3(std::fabs(axes[i].x), std::fabs(axes[i].y), std::fabs(axes[i].z)) * halfExtents[i];
+        }
+        return AABB(center - reach, center + reach);
+    }
+
+    virtual Material* getMaterial() const override { return material; }
+
+private:
+    void computeInverse() {
+        invHalfExtents = Vector3(1.0f / halfExtents.x, 1.0f / halfExtents.y, 1.0f / halfExtents.z);
+    }
+
+    // Gram-Schmidt na ordem x, y, z: axes[0] segue a primeira coluna,
+    // axes[1] a parte da segunda ortogonal a ela e axes[2] a parte da
+    // terceira ortogonal às duas (o sentido de cada coluna é mantido, e
+    // com ele a orientação da base). Colunas já ortogonais só são
+    // normalizadas.
+    void orthonormalize(const Vector3 columns[3]) {
+        for (int i = 0; i < 3; i++) {
+            Vector3 axis = columns[i];
+            for (int j = 0; j < i; j++) axis -= axes[j] * dot(axis, axes[j]);
+            axes[i] = normalize(axis);
+        }
+    }
+
+    // Raio nas coordenadas locais da caixa (origem no centro, eixos "axes")
+    Ray localRay(const Ray& ray) const {
+        Vector3 offset = ray.origin - center;
+        return Ray(Vector3(dot(axes[0], offset), dot(axes[1], offset), dot(axes[2], offset)),
+                   Vector3(dot(axes[0], ray.direction), dot(axes[1], ray.direction), dot(axes[2], ray.direction)));
+    }
+
+    // Pacote nas coordenadas locais; o construtor calcula o inverso das
+    // direções uma vez por pacote
+    RayPacket localPacket(const RayPacket& packet, const PacketMask& mask) const {
+        PacketVec3 offset = packet.origin - PacketVec3(center);
+        PacketVec3 x(axes[0]), y(axes[1]), z(axes[2]);
+        return RayPacket(PacketVec3(dot(offset, x), dot(offset, y), dot(offset, z)),
+                         PacketVec3(dot(packet.direction, x), dot(packet.direction, y), dot(packet.direction, z)), mask);
+    }
+
+    // Intervalo [tEnter, tExit] do raio local dentro da caixa (vazio se
+    // tEnter > tExit), com o inverso da direção local pré-calculado pelo
+    // chamador, como em AABB::hit. As direções dos slabs são os eixos da
+    // caixa, então o invDir do raio no espaço do mundo não serve: o inverso
+    // local é calculado uma vez por raio (ou pacote) em hit/occluded. Como
+    // em Box, as comparações descartam NaN (origem sobre um plano, direção
+    // paralela).
+    void slabs(const Vector3& origin, const Vector3& invDir, float& tEnter, float& tExit) const {
+        tEnter = -std::numeric_limits<float>::infinity();
+        tExit = std::numeric_limits<float>::infinity();
+        for (int i = 0; i < 3; i++) {
+            float t1 = (-halfExtents[i] - origin[i]) * invDir[i];
+            float t2 = (halfExtents[i] - origin[i]) * invDir[i];
+            float enter = t1 < t2 ? t1 : t2;
+            float leave = t1 < t2 ? t2 : t1;
+            tEnter = enter > tEnter ? enter : tEnter;
+            tExit = leave < tExit ? leave : tExit;
+        }
+    }
+
+    void slabs(const RayPacket& local, PacketFloat& tEnter, PacketFloat& tExit) const {
+        tEnter = PacketFloat(-std::numeric_limits<float>::infinity());
+        tExit = PacketFloat(std::numeric_limits<float>::infinity());
+        slab(halfExtents.x, local.origin.x, local.invDirection.x, tEnter, tExit);
+        slab(halfExtents.y, local.origin.y, local.invDirection.y, tEnter, tExit);
+        slab(halfExtents.z, local.origin.z, local.invDirection.z, tEnter, tExit);
+    }
+
+    static void slab(float half, const PacketFloat& origin, const PacketFloat& invDir,
+                     PacketFloat& tEnter, PacketFloat& tExit) {
+        PacketFloat t1 = (PacketFloat(-half) - origin) * invDir;
+        PacketFloat t2 = (PacketFloat(half) - origin) * invDir;
+        PacketFloat enter = select(t1 < t2, t1, t2);
+        PacketFloat leave = select(t1 < t2, t2, t1);
+        tEnter = select(enter > tEnter, enter, tEnter);
+        tExit = select(leave < tExit, leave, tExit);
+    }
+};
+
+#endif // ORIENTED_BOX_H
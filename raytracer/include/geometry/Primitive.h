@@ -2,6 +2,8 @@
 #define PRIMITIVE_H
 
 #include "../core/Ray.h"
+#include "../core/RayPacket.h"
+#include "AABB.h"
 
 // Declaração antecipada de Material
 class Material;
@@ -28,6 +30,53 @@ public:
 
     // Verifica se há interseção entre o raio e a primitiva
     virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const = 0;
+
+    // Verifica se algum ponto da primitiva bloqueia o raio no intervalo
+    // [tMin, tMax] (consulta de oclusão para raios de sombra). Não calcula
+    // ponto, normal nem material; as primitivas devem sobrescrever com um
+    // teste mais barato que o de hit.
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const {
+        HitRecord record;
+        return hit(ray, tMin, tMax, record);
+    }
+
+    // Interseção de um pacote de raios nas lanes de "mask": onde a primitiva
+    // for atingida no intervalo [tMin, result.t], atualiza result com a
+    // distância e com "index". A versão padrão testa lane a lane com hit;
+    // as primitivas simples sobrescrevem com um teste vetorial.
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const {
+        HitRecord record;
+        for (unsigned int bits = mask.bits(); bits; bits &= bits - 1) {
+            int lane = lowestLane(bits);
+            if (hit(packet.ray(lane), tMin, result.t[lane], record)) {
+                result.update(lane, record.t, index);
+            }
+        }
+    }
+
+    // Consulta de oclusão para um pacote: lanes de "mask" em que a primitiva
+    // bloqueia o raio no intervalo [tMin, tMax]
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const {
+        unsigned int blocked = 0;
+        for (unsigned int bits = mask.bits(); bits; bits &= bits - 1) {
+            int lane = lowestLane(bits);
+            if (occluded(packet.ray(lane), tMin, tMax[lane])) blocked |= 1u << lane;
+        }
+        return PacketMask::fromBits(blocked);
+    }
+
+    // Retorna a caixa delimitadora alinhada aos eixos da primitiva
+    virtual AABB boundingBox() const = 0;
+
+    // Material da primitiva (nullptr se não houver um material único)
+    virtual Material* getMaterial() const { return nullptr; }
+
+    // Memória das estruturas de aceleração próprias da primitiva (a BVH de
+    // uma malha, por exemplo), em bytes. BLAS compartilhadas por instâncias
+    // são contadas uma única vez pela Scene.
+    virtual size_t accelerationMemory() const { return 0; }
 };
 
 #endif // PRIMITIVE_H 
\ No newline at end of file
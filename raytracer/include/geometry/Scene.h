@@ -2,25 +2,56 @@
 #define SCENE_H
 
 #include <vector>
+#include <set>
+#include <memory>
 #include "Primitive.h"
+#include "Instance.h"
 #include "../light/Light.h"
 #include "../light/AmbientLight.h"
 #include "../material/Material.h"
+#include "../accel/BVH.h"
+#include "../accel/Grid.h"
+#include "../accel/KdTree.h"
+#include "../transform/AffineTransform.h"
+
+// Estrutura de aceleração usada pela cena: todas respondem às mesmas
+// consultas, e a melhor depende da distribuição dos objetos
+enum class AcceleratorType {
+    BVH,        // Hierarquia de volumes (padrão), com refit nas cenas animadas
+    Grid,       // Grade em dois níveis: construção mais rápida, boa com objetos pequenos e uniformes
+    KdTree      // Árvore kd com SAH: isola o espaço vazio, boa em cenas esparsas
+};
+
+// Resultado de Scene::update
+struct SceneUpdate {
+    int moved;          // Objetos cujas caixas mudaram desde o quadro anterior
+    bool rebuilt;       // A BVH foi reconstruída em vez de ajustada
+    float degradation;  // Custo SAH da BVH em relação ao da última construção
+};
 
 class Scene {
 public:
     std::vector<Primitive*> objects;
     std::vector<Light*> lights;
     AmbientLight ambientLight;
+    AcceleratorType accelerator;    // Estrutura construída por build
+    BVH bvh;        // Estruturas de aceleração sobre "objects" (só a de "accelerator" é construída)
+    Grid grid;
+    KdTree kdTree;
+    std::vector<char> castsShadow;  // Indica se cada objeto bloqueia a luz
+    std::vector<AABB> objectBounds; // Caixa de cada objeto na última construção ou atualização
+    float rebuildThreshold;         // update reconstrói a BVH quando o custo SAH passa desse fator
     
     // Construtores
-    Scene() : ambientLight() {}
+    Scene() : ambientLight(), accelerator(AcceleratorType::BVH), rebuildThreshold(1.5f) {}
     
-    Scene(const AmbientLight& ambientLight) : ambientLight(ambientLight) {}
+    Scene(const AmbientLight& ambientLight)
+        : ambientLight(ambientLight), accelerator(AcceleratorType::BVH), rebuildThreshold(1.5f) {}
     
     // Adiciona um objeto à cena
     void addObject(Primitive* object) {
         objects.push_back(object);
+        clearAccelerator();  // A estrutura precisa ser reconstruída
     }
     
     // Adiciona uma fonte de luz à cena
@@ -33,13 +64,127 @@ public:
         ambientLight = light;
     }
     
+    // Constrói a estrutura de "accelerator" (a BVH por padrão) sobre os
+    // objetos da cena. Deve ser chamado depois de
+    // adicionar todos os objetos e antes de renderizar. Cadeias de
+    // transformações (Translate, Rotate, Scale) são antes reduzidas a um
+    // único AffineTransform, guardado pela cena e usado só nas consultas;
+    // "objects" e os objetos originais não são alterados.
+    void build() {
+        collapsed.clear();
+        traced.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            traced[i] = AffineTransform::collapse(objects[i]);
+            if (traced[i] != objects[i]) collapsed.emplace_back(traced[i]);
+        }
+        
+        objectBounds.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            objectBounds[i] = traced[i]->boundingBox();
+        }
+        buildAccelerator();
+        
+        castsShadow.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            castsShadow[i] = !isLightFixture(objects[i]->getMaterial());
+        }
+    }
+    
+    // Atualização por quadro de uma cena animada, depois de mover objetos
+    // (Translate::offset, Rotate::setAngle, Instance::setTransform...). As
+    // cadeias reduzidas em build são recompostas, e os objetos cujas caixas
+    // mudaram são ajustados na BVH com refit: só os caminhos até a raiz são
+    // recalculados, e as BVHs das malhas e BLAS não são tocadas. A BVH só é
+    // reconstruída quando o custo SAH passa de rebuildThreshold vezes o da
+    // última construção (ou se o layout não permite refit). A grade e a
+    // árvore kd são sempre reconstruídas. Objetos novos exigem um build
+    // completo, feito aqui se necessário.
+    SceneUpdate update() {
+        SceneUpdate result = {0, false, 1.0f};
+        if (!isAccelerated() || objectBounds.size() != objects.size()) {
+            build();
+            result.moved = static_cast<int>(objects.size());
+            result.rebuilt = true;
+            return result;
+        }
+        
+        std::vector<int> changed;
+        for (size_t i = 0; i < objects.size(); i++) {
+            AffineTransform* transform = dynamic_cast<AffineTransform*>(traced[i]);
+            if (transform) transform->sync();
+            AABB box = traced[i]->boundingBox();
+            if (!sameBounds(box, objectBounds[i])) {
+                objectBounds[i] = box;
+                changed.push_back(static_cast<int>(i));
+            }
+        }
+        result.moved = static_cast<int>(changed.size());
+        
+        if (!changed.empty()) {
+            if (accelerator != AcceleratorType::BVH || !bvh.refit(objectBounds, changed) ||
+                bvh.degradation() > rebuildThreshold) {
+                buildAccelerator();
+                result.rebuilt = true;
+            }
+        }
+        result.degradation = bvh.degradation();
+        return result;
+    }
+    
+    // Objeto consultado no lugar de objects[index]: depois de build, a
+    // cadeia reduzida a um AffineTransform (ou o próprio objeto)
+    Primitive* tracedObject(int index) const {
+        return isAccelerated() ? traced[index] : objects[index];
+    }
+    
+    // Caixa de todos os objetos, da estrutura construída (vazia antes de build)
+    AABB bounds() const {
+        if (bvh.isBuilt()) return bvh.nodes[0].bounds;
+        if (grid.isBuilt()) return grid.bounds();
+        return kdTree.bounds();
+    }
+    
+    // Memória da estrutura de aceleração sobre os objetos, em bytes
+    size_t acceleratorMemory() const {
+        return bvh.memoryUsage() + grid.memoryUsage() + kdTree.memoryUsage();
+    }
+    
+    // Memória de todas as estruturas de aceleração da cena, em bytes: a da
+    // cena, as das primitivas e a de cada BLAS (uma vez, mesmo que seja
+    // compartilhada por várias instâncias)
+    size_t accelerationMemory() const {
+        size_t total = acceleratorMemory();
+        std::set<const BLAS*> shared;
+        for (size_t i = 0; i < objects.size(); i++) {
+            total += objects[i]->accelerationMemory();
+            const Instance* instance = dynamic_cast<const Instance*>(objects[i]);
+            if (instance && shared.insert(instance->geometry.get()).second) {
+                total += instance->geometry->memoryUsage();
+            }
+        }
+        return total;
+    }
+    
     // Verifica se um raio atinge algum objeto na cena
     bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const {
         HitRecord tempRecord;
+        auto hitObject = [&](int index, float& closestSoFar) {
+            if (traced[index]->hit(ray, tMin, closestSoFar, tempRecord)) {
+                closestSoFar = tempRecord.t;
+                record = tempRecord;
+                return true;
+            }
+            return false;
+        };
+        
+        if (bvh.isBuilt()) return bvh.intersect(ray, tMin, tMax, hitObject);
+        if (grid.isBuilt()) return grid.intersect(ray, tMin, tMax, hitObject);
+        if (kdTree.isBuilt()) return kdTree.intersect(ray, tMin, tMax, hitObject);
+        
         bool hitAnything = false;
         float closestSoFar = tMax;
         
-        // Verificar interseção com cada objeto
+        // Sem BVH: verificar interseção com cada objeto
         for (const auto& object : objects) {
             if (object->hit(ray, tMin, closestSoFar, tempRecord)) {
                 hitAnything = true;
@@ -51,10 +196,27 @@ public:
         return hitAnything;
     }
     
-    // Verifica se há sombra entre um ponto e uma luz
-    bool isShadowed(const Vector3& point, const Light* light) const {
-        Vector3 lightDir = light->getDirection(point);
-        float lightDist = light->getDistance(point);
+    // Interseção mais próxima de cada raio ativo de um pacote: result.t
+    // recebe a distância e result.primitive o índice do objeto em "objects"
+    // (-1 sem interseção). O registro completo de uma lane é obtido depois
+    // com tracedObject(index)->hit, só para as lanes que atingiram algo.
+    void hitPacket(const RayPacket& packet, float tMin, PacketHit& result) const {
+        auto hitObject = [&](int index, const PacketMask& mask) {
+            traced[index]->hitPacket(packet, mask, tMin, result, index);
+        };
+        if (bvh.isBuilt()) return bvh.intersectPacket(packet, tMin, result, hitObject);
+        if (grid.isBuilt()) return grid.intersectPacket(packet, tMin, result, hitObject);
+        if (kdTree.isBuilt()) return kdTree.intersectPacket(packet, tMin, result, hitObject);
+        
+        for (size_t i = 0; i < objects.size(); i++) {
+            objects[i]->hitPacket(packet, packet.active, tMin, result, static_cast<int>(i));
+        }
+    }
+    
+    // Verifica se há sombra entre um ponto e o ponto amostrado de uma luz
+    bool isShadowed(const Vector3& point, const LightSample& sample) const {
+        const Vector3& lightDir = sample.direction;
+        float lightDist = sample.distance;
         
         // Usar uma pequena distância de offset para evitar auto-sombreamento
         const float shadowEpsilon = 0.001f;
@@ -62,24 +224,80 @@ public:
         // Raio da sombra (do ponto para a luz)
         Ray shadowRay(point + lightDir * shadowEpsilon, lightDir);
         
-        // Verificar interseção com os objetos, ignorando objetos emissivos
-        HitRecord tempRecord;
+        // Consulta de oclusão: para no primeiro bloqueio, ignorando objetos emissivos
+        float tMax = lightDist - shadowEpsilon;
+        auto blocks = [&](int index) {
+            return castsShadow[index] && traced[index]->occluded(shadowRay, shadowEpsilon, tMax);
+        };
+        if (bvh.isBuilt()) return bvh.occluded(shadowRay, shadowEpsilon, tMax, blocks);
+        if (grid.isBuilt()) return grid.occluded(shadowRay, shadowEpsilon, tMax, blocks);
+        if (kdTree.isBuilt()) return kdTree.occluded(shadowRay, shadowEpsilon, tMax, blocks);
+        
         for (const auto& object : objects) {
-            // Se o objeto for a fonte de luz, ignorar
-            if (object->hit(shadowRay, shadowEpsilon, lightDist - shadowEpsilon, tempRecord)) {
-                // Verificar se é um objeto emissor de luz (lâmpada)
-                if (tempRecord.material) {
-                    const Color& ambient = tempRecord.material->ambient;
-                    if (ambient.r >= 0.9f && ambient.g >= 0.9f && ambient.b >= 0.9f) {
-                        continue;  // Ignorar objetos emissores de luz
-                    }
-                }
+            if (!isLightFixture(object->getMaterial()) &&
+                object->occluded(shadowRay, shadowEpsilon, tMax)) {
                 return true; // Há um objeto bloqueando a luz
             }
         }
         
         return false; // Nenhum objeto bloqueando a luz
     }
+    
+    // Versão de isShadowed para um pacote: lanes de "mask" com sombra entre
+    // o ponto e a amostra de luz (direção e distância de cada lane)
+    PacketMask isShadowed(const PacketVec3& point, const PacketVec3& lightDir, const PacketFloat& lightDist,
+                          const PacketMask& mask) const {
+        const float shadowEpsilon = 0.001f;
+        RayPacket shadowPacket(point + lightDir * PacketFloat(shadowEpsilon), lightDir, mask);
+        PacketFloat tMax = lightDist - PacketFloat(shadowEpsilon);
+        
+        auto blocks = [&](int index, const PacketMask& lanes) {
+            if (!castsShadow[index]) return PacketMask();
+            return traced[index]->occludedPacket(shadowPacket, lanes, shadowEpsilon, tMax);
+        };
+        if (bvh.isBuilt()) return bvh.occludedPacket(shadowPacket, shadowEpsilon, tMax, blocks);
+        if (grid.isBuilt()) return grid.occludedPacket(shadowPacket, shadowEpsilon, tMax, blocks);
+        if (kdTree.isBuilt()) return kdTree.occludedPacket(shadowPacket, shadowEpsilon, tMax, blocks);
+        
+        PacketMask blocked;
+        for (const auto& object : objects) {
+            if (isLightFixture(object->getMaterial())) continue;
+            blocked = blocked | object->occludedPacket(shadowPacket, mask & !blocked, shadowEpsilon, tMax);
+        }
+        return blocked;
+    }
+    
+private:
+    std::vector<Primitive*> traced;                     // Objeto consultado para cada objects[i]
+    std::vector<std::unique_ptr<Primitive>> collapsed;  // Cadeias reduzidas em build (donas dos AffineTransform)
+    
+    bool isAccelerated() const { return bvh.isBuilt() || grid.isBuilt() || kdTree.isBuilt(); }
+    
+    void clearAccelerator() {
+        bvh.clear();
+        grid.clear();
+        kdTree.clear();
+    }
+    
+    // Reconstrói a estrutura de "accelerator" com objectBounds
+    void buildAccelerator() {
+        clearAccelerator();
+        if (accelerator == AcceleratorType::Grid) grid.build(objectBounds);
+        else if (accelerator == AcceleratorType::KdTree) kdTree.build(objectBounds);
+        else bvh.build(objectBounds);
+    }
+    
+    static bool sameBounds(const AABB& a, const AABB& b) {
+        return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z &&
+               a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+    }
+    
+    // Objetos emissores de luz (lâmpadas) não projetam sombra
+    static bool isLightFixture(const Material* material) {
+        if (!material) return false;
+        const Color& ambient = material->ambient;
+        return ambient.r >= 0.9f && ambient.g >= 0.9f && ambient.b >= 0.9f;
+    }
 };
 
 #endif // SCENE_H 
\ No newline at end of file
@@ -17,20 +17,13 @@ public:
 
     // Implementação da função hit para verificar interseção com um raio
     virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
-        Vector3 oc = ray.origin - center;
-        float a = ray.direction.squaredLength();
-        float halfB = dot(oc, ray.direction);
-        float c = oc.squaredLength() - radius * radius;
-        
-        float discriminant = halfB * halfB - a * c;
-        if (discriminant < 0) return false;
-        
-        float sqrtd = sqrt(discriminant);
+        float nearRoot, farRoot;
+        if (!roots(ray, nearRoot, farRoot)) return false;
         
         // Encontrar a raiz mais próxima dentro do intervalo aceitável
-        float root = (-halfB - sqrtd) / a;
+        float root = nearRoot;
         if (root < tMin || tMax < root) {
-            root = (-halfB + sqrtd) / a;
+            root = farRoot;
             if (root < tMin || tMax < root)
                 return false;
         }
@@ -44,6 +37,81 @@ public:
         
         return true;
     }
+
+    // Mesmo teste de hit, sem calcular o ponto e a normal
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        float nearRoot, farRoot;
+        if (!roots(ray, nearRoot, farRoot)) return false;
+        if (nearRoot >= tMin && nearRoot <= tMax) return true;
+        return farRoot >= tMin && farRoot <= tMax;
+    }
+
+    // Mesmo teste de hit para um pacote de raios, com as raízes de todas as lanes calculadas juntas
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        PacketFloat nearRoot, farRoot;
+        PacketMask valid = mask & roots(packet, nearRoot, farRoot);
+        if (valid.none()) return;
+        
+        PacketFloat lower(tMin);
+        PacketMask nearOk = (nearRoot >= lower) & (nearRoot <= result.t);
+        PacketMask farOk = (farRoot >= lower) & (farRoot <= result.t);
+        result.update(valid & (nearOk | farOk), select(nearOk, nearRoot, farRoot), index);
+    }
+
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        PacketFloat nearRoot, farRoot;
+        PacketMask valid = mask & roots(packet, nearRoot, farRoot);
+        if (valid.none()) return valid;
+        
+        PacketFloat lower(tMin);
+        PacketMask nearOk = (nearRoot >= lower) & (nearRoot <= tMax);
+        PacketMask farOk = (farRoot >= lower) & (farRoot <= tMax);
+        return valid & (nearOk | farOk);
+    }
+
+    virtual AABB boundingBox() const override {
+        Vector3 r(radius, radius, radius);
+        return AABB(center - r, center + r);
+    }
+
+    virtual Material* getMaterial() const override { return material; }
+
+private:
+    // Raízes da equação do raio com a esfera; retorna false se o discriminante
+    // for negativo. O discriminante halfB² - a·c é calculado como
+    // a·(r² - |l|²), com l o vetor do centro ao ponto do raio mais próximo
+    // dele: longe da esfera |oc|² é muito maior que r² e a subtração direta
+    // perde todos os dígitos de r², acusando acertos fora da caixa envolvente
+    bool roots(const Ray& ray, float& nearRoot, float& farRoot) const {
+        Vector3 oc = ray.origin - center;
+        float a = ray.direction.squaredLength();
+        float halfB = dot(oc, ray.direction);
+        Vector3 l = oc - ray.direction * (halfB / a);
+        
+        float discriminant = a * (radius * radius - l.squaredLength());
+        if (discriminant < 0) return false;
+        
+        float sqrtd = sqrt(discriminant);
+        nearRoot = (-halfB - sqrtd) / a;
+        farRoot = (-halfB + sqrtd) / a;
+        return true;
+    }
+
+    // Mesmo cálculo em cada lane; retorna as lanes com discriminante não negativo
+    PacketMask roots(const RayPacket& packet, PacketFloat& nearRoot, PacketFloat& farRoot) const {
+        PacketVec3 oc = packet.origin - PacketVec3(center);
+        PacketFloat a = packet.direction.squaredLength();
+        PacketFloat halfB = dot(oc, packet.direction);
+        PacketVec3 l = oc - packet.direction * (halfB / a);
+        
+        PacketFloat discriminant = a * (PacketFloat(radius * radius) - l.squaredLength());
+        PacketFloat sqrtd = sqrt(max(discriminant, PacketFloat(0.0f)));
+        nearRoot = (-halfB - sqrtd) / a;
+        farRoot = (-halfB + sqrtd) / a;
+        return discriminant >= PacketFloat(0.0f);
+    }
 };
 
 #endif // SPHERE_H 
\ No newline at end of file
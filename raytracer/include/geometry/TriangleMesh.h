@@ -0,0 +1,147 @@
+#ifndef TRIANGLE_MESH_H
+#define TRIANGLE_MESH_H
+
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cmath>
+#include "Primitive.h"
+#include "../accel/BVH.h"
+
+// Dados de uma malha indexada em arrays contíguos. Podem ser compartilhados
+// por várias TriangleMesh (instâncias) sem cópia.
+struct MeshData {
+    std::vector<Vector3> positions;         // Posições dos vértices
+    std::vector<Vector3> normals;           // Normais (opcional)
+    std::vector<unsigned int> indices;      // 3 índices de posição por triângulo
+    std::vector<unsigned int> normalIndices; // 3 índices de normal por triângulo (opcional)
+
+    int triangleCount() const { return static_cast<int>(indices.size() / 3); }
+
+    bool hasNormals() const { return !normalIndices.empty(); }
+};
+
+// Malha de triângulos com BVH própria sobre os triângulos
+class TriangleMesh : public Primitive {
+public:
+    std::shared_ptr<const MeshData> mesh;
+    Material* material;
+    BVH bvh;
+
+    // buildMode escolhe entre a BVH de melhor qualidade (SAH), a construção
+    // mais rápida (LBVH), útil para malhas muito grandes ou reconstruídas, e
+    // a construção sob demanda (Lazy), que só constrói as partes atingidas;
+    // layout escolhe o formato dos nós (Compressed para economizar memória)
+    TriangleMesh(const std::shared_ptr<const MeshData>& mesh, Material* material,
+                 BVHBuildMode buildMode = BVHBuildMode::SAH, BVHLayout layout = BVHLayout::Wide)
+        : mesh(mesh), material(material), bvh(4, buildMode, layout) {
+        buildBVH();
+    }
+
+    virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
+        if (!bvh.isBuilt()) return false;
+        int hitTriangle = -1;
+        float hitT = 0.0f, hitU = 0.0f, hitV = 0.0f;
+
+        // A travessia só guarda o triângulo e as coordenadas baricêntricas;
+        // ponto e normal são calculados uma única vez no final
+        bool found = bvh.intersect(ray, tMin, tMax, [&](int triangle, float& closestSoFar) {
+            float t, u, v;
+            if (intersectTriangle(triangle, ray, tMin, closestSoFar, t, u, v)) {
+                closestSoFar = t;
+                hitTriangle = triangle;
+                hitT = t;
+                hitU = u;
+                hitV = v;
+                return true;
+            }
+            return false;
+        });
+        if (!found) return false;
+
+        const MeshData& m = *mesh;
+        const unsigned int* idx = &m.indices[3 * hitTriangle];
+        const Vector3& p0 = m.positions[idx[0]];
+        const Vector3& p1 = m.positions[idx[1]];
+        const Vector3& p2 = m.positions[idx[2]];
+
+        Vector3 edge1 = p1 - p0;
+        Vector3 edge2 = p2 - p0;
+        record.t = hitT;
+        record.point = p0 * (1.0f - hitU - hitV) + p1 * hitU + p2 * hitV;
+
+        Vector3 normal;
+        if (m.hasNormals()) {
+            // Interpolação das normais dos vértices
+            const unsigned int* nIdx = &m.normalIndices[3 * hitTriangle];
+            normal = normalize(m.normals[nIdx[0]] * (1.0f - hitU - hitV) +
+                               m.normals[nIdx[1]] * hitU + m.normals[nIdx[2]] * hitV);
+        } else {
+            normal = normalize(cross(edge1, edge2));
+        }
+        record.setFaceNormal(ray, normal);
+        record.material = material;
+
+        return true;
+    }
+
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        if (!bvh.isBuilt()) return false;
+        return bvh.occluded(ray, tMin, tMax, [&](int triangle) {
+            float t, u, v;
+            return intersectTriangle(triangle, ray, tMin, tMax, t, u, v);
+        });
+    }
+
+    virtual AABB boundingBox() const override {
+        return bvh.isBuilt() ? bvh.nodes[0].bounds : AABB();
+    }
+
+    virtual Material* getMaterial() const override { return material; }
+
+    virtual size_t accelerationMemory() const override { return bvh.memoryUsage(); }
+
+private:
+    void buildBVH() {
+        const MeshData& m = *mesh;
+        int n = m.triangleCount();
+        // Malha vazia: nenhum nó, e hit/occluded retornam false
+        if (n == 0) return;
+        std::vector<AABB> bounds(n);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            bounds[i].expand(m.positions[m.indices[3 * i]]);
+            bounds[i].expand(m.positions[m.indices[3 * i + 1]]);
+            bounds[i].expand(m.positions[m.indices[3 * i + 2]]);
+        }
+        bvh.build(std::move(bounds));
+    }
+
+    // Interseção raio-triângulo de Möller-Trumbore
+    bool intersectTriangle(int triangle, const Ray& ray, float tMin, float tMax,
+                           float& t, float& u, float& v) const {
+        const MeshData& m = *mesh;
+        const unsigned int* idx = &m.indices[3 * triangle];
+        const Vector3& p0 = m.positions[idx[0]];
+        Vector3 edge1 = m.positions[idx[1]] - p0;
+        Vector3 edge2 = m.positions[idx[2]] - p0;
+
+        Vector3 pvec = cross(ray.direction, edge2);
+        float det = dot(edge1, pvec);
+        if (std::fabs(det) < 1e-12f) return false;  // Raio paralelo ao triângulo
+        float invDet = 1.0f / det;
+
+        Vector3 tvec = ray.origin - p0;
+        u = dot(tvec, pvec) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        Vector3 qvec = cross(tvec, edge1);
+        v = dot(ray.direction, qvec) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        t = dot(edge2, qvec) * invDet;
+        return t >= tMin && t <= tMax;
+    }
+};
+
+#endif // TRIANGLE_MESH_H
@@ -0,0 +1,391 @@
+#ifndef DEFLATE_H
+#define DEFLATE_H
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// Compressor DEFLATE (RFC 1951) com LZ77 por cadeias de hash e blocos com
+// códigos de Huffman dinâmicos. Cada chamada de compress() codifica um trecho
+// independente (sem referências a trechos anteriores) e termina alinhada em
+// byte; trechos comprimidos em paralelo podem assim ser concatenados num único
+// fluxo, como faz o pigz.
+class Deflate {
+public:
+    // Comprime "size" bytes e acrescenta os blocos em "out". Se "last" for
+    // falso, o trecho termina com um bloco vazio não comprimido (sync flush);
+    // se for verdadeiro, o último bloco é marcado como final.
+    static void compress(const unsigned char* data, size_t size, std::vector<unsigned char>& out, bool last) {
+        BitWriter writer(out);
+        std::vector<uint32_t> tokens;
+        tokens.reserve(std::min(size, static_cast<size_t>(MaxTokensPerBlock)));
+
+        Matcher matcher(data, size);
+        size_t pos = 0;
+        while (pos < size) {
+            // Um bloco a cada MaxTokensPerBlock símbolos
+            tokens.clear();
+            while (pos < size && tokens.size() < MaxTokensPerBlock) {
+                int distance = 0;
+                int length = matcher.findMatch(pos, distance);
+                if (length >= MinMatch) {
+                    tokens.push_back(MatchFlag | (static_cast<uint32_t>(length - MinMatch) << 16) |
+                                     static_cast<uint32_t>(distance - 1));
+                    for (int i = 0; i < length; i++) matcher.insert(pos + i);
+                    pos += length;
+                } else {
+                    tokens.push_back(data[pos]);
+                    matcher.insert(pos);
+                    pos++;
+                }
+            }
+            writeDynamicBlock(writer, tokens, last && pos >= size);
+        }
+
+        if (size == 0 && last) {
+            // Bloco final vazio com códigos fixos: BFINAL=1, BTYPE=01, fim de bloco (7 bits zero)
+            writer.putBits(1, 1);
+            writer.putBits(1, 2);
+            writer.putBits(0, 7);
+        } else if (!last) {
+            // Sync flush: bloco não comprimido vazio, alinhado em byte
+            writer.putBits(0, 1);
+            writer.putBits(0, 2);
+            writer.alignToByte();
+            writer.putBits(0x0000, 16);
+            writer.putBits(0xffff, 16);
+        }
+        writer.alignToByte();
+    }
+
+    // Fluxo zlib (RFC 1950) completo: cabeçalho, blocos DEFLATE e Adler-32
+    static void zlibCompress(const unsigned char* data, size_t size, std::vector<unsigned char>& out) {
+        out.push_back(0x78);
+        out.push_back(0x9c);
+        compress(data, size, out, true);
+        uint32_t adler = adler32(1, data, size);
+        out.push_back(static_cast<unsigned char>(adler >> 24));
+        out.push_back(static_cast<unsigned char>(adler >> 16));
+        out.push_back(static_cast<unsigned char>(adler >> 8));
+        out.push_back(static_cast<unsigned char>(adler));
+    }
+
+    // Soma de verificação Adler-32, continuando a partir de "adler" (1 no início)
+    static uint32_t adler32(uint32_t adler, const unsigned char* data, size_t size) {
+        uint32_t a = adler & 0xffff;
+        uint32_t b = adler >> 16;
+        while (size > 0) {
+            size_t n = std::min(size, static_cast<size_t>(5552));  // Sem estouro antes do módulo
+            size -= n;
+            while (n--) {
+                a += *data++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+private:
+    static const int MinMatch = 3;
+    static const int MaxMatch = 258;
+    static const int WindowSize = 32768;
+    static const int MaxChain = 48;                 // Candidatos examinados por posição
+    static const size_t MaxTokensPerBlock = 65536;
+    static const uint32_t MatchFlag = 0x80000000u;
+
+    // Escrita de bits do menos para o mais significativo
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<unsigned char>& out) : out(out), buffer(0), count(0) {}
+
+        void putBits(uint32_t value, int bits) {
+            buffer |= static_cast<uint64_t>(value) << count;
+            count += bits;
+            while (count >= 8) {
+                out.push_back(static_cast<unsigned char>(buffer));
+                buffer >>= 8;
+                count -= 8;
+            }
+        }
+
+        void alignToByte() {
+            if (count > 0) {
+                out.push_back(static_cast<unsigned char>(buffer));
+                buffer = 0;
+                count = 0;
+            }
+        }
+
+    private:
+        std::vector<unsigned char>& out;
+        uint64_t buffer;
+        int count;
+    };
+
+    // Busca de repetições com tabela de hash de 3 bytes e cadeias de posições
+    class Matcher {
+    public:
+        Matcher(const unsigned char* data, size_t size)
+            : data(data), size(size), head(HashSize, -1), prev(WindowSize, -1) {}
+
+        void insert(size_t pos) {
+            if (pos + MinMatch > size) return;
+            uint32_t h = hash(pos);
+            prev[pos & (WindowSize - 1)] = head[h];
+            head[h] = static_cast<long>(pos);
+        }
+
+        int findMatch(size_t pos, int& distance) const {
+            if (pos + MinMatch > size) return 0;
+            int maxLength = static_cast<int>(std::min(static_cast<size_t>(MaxMatch), size - pos));
+            int bestLength = 0;
+            long candidate = head[hash(pos)];
+            long minPos = static_cast<long>(pos) - WindowSize;
+
+            for (int chain = 0; chain < MaxChain && candidate >= 0 && candidate > minPos; chain++) {
+                const unsigned char* a = data + candidate;
+                const unsigned char* b = data + pos;
+                if (a[bestLength] == b[bestLength]) {
+                    int length = 0;
+                    while (length < maxLength && a[length] == b[length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        distance = static_cast<int>(pos - candidate);
+                        if (length == maxLength) break;
+                    }
+                }
+                long next = prev[candidate & (WindowSize - 1)];
+                if (next >= candidate) break;  // Entrada já sobrescrita na janela
+                candidate = next;
+            }
+            return bestLength >= MinMatch ? bestLength : 0;
+        }
+
+    private:
+        static const int HashBits = 15;
+        static const int HashSize = 1 << HashBits;
+
+        uint32_t hash(size_t pos) const {
+            uint32_t v = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16);
+            return (v * 2654435761u) >> (32 - HashBits);
+        }
+
+        const unsigned char* data;
+        size_t size;
+        std::vector<long> head;
+        std::vector<long> prev;
+    };
+
+    // Tabelas de comprimentos (símbolos 257..285) e distâncias (0..29)
+    static int lengthSymbol(int length, int& extraBits, int& extraValue) {
+        static const int base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        int code = 28;
+        while (base[code] > length) code--;
+        extraBits = extra[code];
+        extraValue = length - base[code];
+        return 257 + code;
+    }
+
+    static int distanceSymbol(int distance, int& extraBits, int& extraValue) {
+        static const int base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                     257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                     8193, 12289, 16385, 24577};
+        int code = 29;
+        while (base[code] > distance) code--;
+        extraBits = code < 4 ? 0 : (code - 2) / 2;
+        extraValue = distance - base[code];
+        return code;
+    }
+
+    // Comprimentos de código de Huffman limitados a maxBits. Se a árvore ficar
+    // profunda demais, as frequências são reduzidas à metade e ela é refeita.
+    static void buildLengths(std::vector<uint32_t> freqs, int maxBits, std::vector<int>& lengths) {
+        int n = static_cast<int>(freqs.size());
+        lengths.assign(n, 0);
+
+        while (true) {
+            typedef std::pair<uint64_t, int> Item;  // (frequência, nó)
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+            std::vector<int> parent;
+            for (int i = 0; i < n; i++) {
+                if (freqs[i] > 0) queue.push(Item(freqs[i], i));
+            }
+            parent.assign(n, -1);
+
+            if (queue.size() == 1) {
+                lengths[queue.top().second] = 1;
+                return;
+            }
+            if (queue.empty()) return;
+
+            // Nós internos recebem índices a partir de n
+            while (queue.size() > 1) {
+                Item a = queue.top(); queue.pop();
+                Item b = queue.top(); queue.pop();
+                int node = static_cast<int>(parent.size());
+                parent.push_back(-1);
+                parent[a.second] = node;
+                parent[b.second] = node;
+                queue.push(Item(a.first + b.first, node));
+            }
+
+            int maxLength = 0;
+            for (int i = 0; i < n; i++) {
+                if (freqs[i] == 0) continue;
+                int depth = 0;
+                for (int p = parent[i]; p >= 0; p = parent[p]) depth++;
+                lengths[i] = depth;
+                maxLength = std::max(maxLength, depth);
+            }
+            if (maxLength <= maxBits) return;
+
+            for (int i = 0; i < n; i++) {
+                if (freqs[i] > 0) freqs[i] = (freqs[i] + 1) / 2;
+            }
+        }
+    }
+
+    // Códigos canônicos, já com os bits invertidos para escrita LSB-first
+    static void buildCodes(const std::vector<int>& lengths, std::vector<uint32_t>& codes) {
+        int count[16] = {0};
+        for (size_t i = 0; i < lengths.size(); i++) count[lengths[i]]++;
+        count[0] = 0;
+
+        uint32_t next[16] = {0};
+        uint32_t code = 0;
+        for (int bits = 1; bits < 16; bits++) {
+            code = (code + count[bits - 1]) << 1;
+            next[bits] = code;
+        }
+
+        codes.assign(lengths.size(), 0);
+        for (size_t i = 0; i < lengths.size(); i++) {
+            int len = lengths[i];
+            if (len == 0) continue;
+            uint32_t c = next[len]++;
+            uint32_t reversed = 0;
+            for (int b = 0; b < len; b++) reversed |= ((c >> b) & 1) << (len - 1 - b);
+            codes[i] = reversed;
+        }
+    }
+
+    static void writeDynamicBlock(BitWriter& writer, const std::vector<uint32_t>& tokens, bool final) {
+        // Frequências dos símbolos
+        std::vector<uint32_t> litFreq(286, 0), distFreq(30, 0);
+        int extraBits, extraValue;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            uint32_t t = tokens[i];
+            if (t & MatchFlag) {
+                litFreq[lengthSymbol(((t >> 16) & 0x1ff) + MinMatch, extraBits, extraValue)]++;
+                distFreq[distanceSymbol((t & 0xffff) + 1, extraBits, extraValue)]++;
+            } else {
+                litFreq[t]++;
+            }
+        }
+        litFreq[256] = 1;  // Fim de bloco
+
+        // Pelo menos dois códigos de distância mantêm o código completo
+        int usedDistances = 0;
+        for (int i = 0; i < 30; i++) usedDistances += distFreq[i] > 0;
+        if (usedDistances < 2) {
+            if (distFreq[0] == 0) distFreq[0] = 1;
+            else distFreq[1] = 1;
+        }
+
+        std::vector<int> litLengths, distLengths;
+        buildLengths(litFreq, 15, litLengths);
+        buildLengths(distFreq, 15, distLengths);
+
+        int hlit = 286;
+        while (hlit > 257 && litLengths[hlit - 1] == 0) hlit--;
+        int hdist = 30;
+        while (hdist > 1 && distLengths[hdist - 1] == 0) hdist--;
+
+        // Comprimentos codificados com repetições (símbolos 16, 17 e 18)
+        std::vector<int> all(litLengths.begin(), litLengths.begin() + hlit);
+        all.insert(all.end(), distLengths.begin(), distLengths.begin() + hdist);
+        std::vector<int> clSymbols, clExtra;
+        for (size_t i = 0; i < all.size();) {
+            int value = all[i];
+            size_t run = 1;
+            while (i + run < all.size() && all[i + run] == value) run++;
+
+            if (value == 0 && run >= 3) {
+                int r = static_cast<int>(std::min(run, static_cast<size_t>(138)));
+                if (r >= 11) { clSymbols.push_back(18); clExtra.push_back(r - 11); }
+                else { clSymbols.push_back(17); clExtra.push_back(r - 3); }
+                i += r;
+            } else if (value != 0 && run >= 4) {
+                clSymbols.push_back(value);
+                clExtra.push_back(0);
+                int r = static_cast<int>(std::min(run - 1, static_cast<size_t>(6)));
+                clSymbols.push_back(16);
+                clExtra.push_back(r - 3);
+                i += 1 + r;
+            } else {
+                clSymbols.push_back(value);
+                clExtra.push_back(0);
+                i++;
+            }
+        }
+
+        std::vector<uint32_t> clFreq(19, 0);
+        for (size_t i = 0; i < clSymbols.size(); i++) clFreq[clSymbols[i]]++;
+        int usedCl = 0;
+        for (int i = 0; i < 19; i++) usedCl += clFreq[i] > 0;
+        if (usedCl < 2) clFreq[clFreq[0] ? 1 : 0] = 1;  // Código de comprimentos precisa ser completo
+
+        std::vector<int> clLengths;
+        buildLengths(clFreq, 7, clLengths);
+
+        static const int clOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        int hclen = 19;
+        while (hclen > 4 && clLengths[clOrder[hclen - 1]] == 0) hclen--;
+
+        std::vector<uint32_t> litCodes, distCodes, clCodes;
+        buildCodes(litLengths, litCodes);
+        buildCodes(distLengths, distCodes);
+        buildCodes(clLengths, clCodes);
+
+        // Cabeçalho do bloco
+        writer.putBits(final ? 1 : 0, 1);
+        writer.putBits(2, 2);  // Huffman dinâmico
+        writer.putBits(hlit - 257, 5);
+        writer.putBits(hdist - 1, 5);
+        writer.putBits(hclen - 4, 4);
+        for (int i = 0; i < hclen; i++) writer.putBits(clLengths[clOrder[i]], 3);
+
+        static const int clExtraBits[3] = {2, 3, 7};
+        for (size_t i = 0; i < clSymbols.size(); i++) {
+            int sym = clSymbols[i];
+            writer.putBits(clCodes[sym], clLengths[sym]);
+            if (sym >= 16) writer.putBits(clExtra[i], clExtraBits[sym - 16]);
+        }
+
+        // Dados
+        for (size_t i = 0; i < tokens.size(); i++) {
+            uint32_t t = tokens[i];
+            if (t & MatchFlag) {
+                int sym = lengthSymbol(((t >> 16) & 0x1ff) + MinMatch, extraBits, extraValue);
+                writer.putBits(litCodes[sym], litLengths[sym]);
+                if (extraBits) writer.putBits(extraValue, extraBits);
+
+                sym = distanceSymbol((t & 0xffff) + 1, extraBits, extraValue);
+                writer.putBits(distCodes[sym], distLengths[sym]);
+                if (extraBits) writer.putBits(extraValue, extraBits);
+            } else {
+                writer.putBits(litCodes[t], litLengths[t]);
+            }
+        }
+        writer.putBits(litCodes[256], litLengths[256]);
+    }
+};
+
+#endif // DEFLATE_H
@@ -0,0 +1,217 @@
+#ifndef EXR_WRITER_H
+#define EXR_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <iostream>
+#include "ImageWriter.h"
+#include "Deflate.h"
+
+// Escrita de imagens OpenEXR de uma parte, em linhas (scanlines), com os
+// canais R, G e B da radiância linear em float de 32 bits. Suporta os modos
+// sem compressão (um bloco por linha) e ZIP (blocos de 16 linhas comprimidos
+// com zlib, em paralelo). A tabela de deslocamentos dos blocos é reservada
+// em begin() e preenchida em end(), então a imagem pode ser gravada em
+// blocos durante a renderização.
+class EXRWriter : public ImageWriter {
+public:
+    enum Compression {
+        None = 0,
+        Zip = 3
+    };
+
+    EXRWriter(const std::string& filename, Compression compression = Zip)
+        : filename(filename), compression(compression), file(nullptr), width(0), height(0),
+          nextBlock(0), tableOffset(0) {}
+
+    virtual ~EXRWriter() {
+        if (file) std::fclose(file);
+    }
+
+    virtual bool begin(int imageWidth, int imageHeight) override {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Erro: não foi possível criar " << filename << std::endl;
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        width = imageWidth;
+        height = imageHeight;
+        nextBlock = 0;
+
+        std::vector<unsigned char> header;
+        putUInt32(header, 20000630);    // Número mágico
+        putUInt32(header, 2);           // Versão 2, imagem em linhas de uma parte
+
+        // Canais em ordem alfabética: B, G, R (FLOAT = 2)
+        std::vector<unsigned char> channels;
+        const char* names[3] = {"B", "G", "R"};
+        for (int c = 0; c < 3; c++) {
+            channels.push_back(static_cast<unsigned char>(names[c][0]));
+            channels.push_back(0);
+            putUInt32(channels, 2);     // Tipo do pixel
+            putUInt32(channels, 0);     // pLinear + reservados
+            putUInt32(channels, 1);     // Amostragem em x
+            putUInt32(channels, 1);     // Amostragem em y
+        }
+        channels.push_back(0);
+        putAttribute(header, "channels", "chlist", channels);
+
+        std::vector<unsigned char> value(1, static_cast<unsigned char>(compression));
+        putAttribute(header, "compression", "compression", value);
+
+        std::vector<unsigned char> window;
+        putUInt32(window, 0);
+        putUInt32(window, 0);
+        putUInt32(window, static_cast<uint32_t>(width - 1));
+        putUInt32(window, static_cast<uint32_t>(height - 1));
+        putAttribute(header, "dataWindow", "box2i", window);
+        putAttribute(header, "displayWindow", "box2i", window);
+
+        value.assign(1, 0);             // INCREASING_Y
+        putAttribute(header, "lineOrder", "lineOrder", value);
+
+        value.clear();
+        putFloat(value, 1.0f);
+        putAttribute(header, "pixelAspectRatio", "float", value);
+
+        value.clear();
+        putFloat(value, 0.0f);
+        putFloat(value, 0.0f);
+        putAttribute(header, "screenWindowCenter", "v2f", value);
+
+        value.clear();
+        putFloat(value, 1.0f);
+        putAttribute(header, "screenWindowWidth", "float", value);
+        header.push_back(0);            // Fim do cabeçalho
+
+        // Tabela de deslocamentos, preenchida em end()
+        tableOffset = header.size();
+        offsets.assign(blockCount(), 0);
+        header.resize(header.size() + offsets.size() * sizeof(uint64_t), 0);
+        return std::fwrite(&header[0], 1, header.size(), file) == header.size();
+    }
+
+    virtual bool writeRows(const Framebuffer& image, int /*y0*/, int y1) override {
+        if (!file) return false;
+        int rows = linesPerBlock();
+
+        // Grava os blocos cujas linhas já estão todas no Framebuffer; as
+        // linhas restantes de um bloco incompleto ficam para a próxima chamada
+        int first = nextBlock;
+        int last = first;
+        while (last < blockCount() && std::min((last + 1) * rows, height) <= y1) last++;
+        if (last == first) return true;
+
+        // Cada bloco é montado (e comprimido) de forma independente
+        blocks.resize(last - first);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int b = first; b < last; b++) {
+            packBlock(image, b, blocks[b - first]);
+        }
+
+        for (int b = first; b < last; b++) {
+            const std::vector<unsigned char>& block = blocks[b - first];
+            offsets[b] = static_cast<uint64_t>(std::ftell(file));
+            std::vector<unsigned char> prefix;
+            putUInt32(prefix, static_cast<uint32_t>(b * rows));
+            putUInt32(prefix, static_cast<uint32_t>(block.size()));
+            if (std::fwrite(&prefix[0], 1, prefix.size(), file) != prefix.size()) return false;
+            if (std::fwrite(&block[0], 1, block.size(), file) != block.size()) return false;
+        }
+        nextBlock = last;
+        return true;
+    }
+
+    virtual bool end() override {
+        if (!file) return false;
+        bool ok = nextBlock == blockCount();
+        if (!ok) std::cerr << "Erro: imagem incompleta em " << filename << std::endl;
+
+        std::vector<unsigned char> table;
+        for (size_t i = 0; i < offsets.size(); i++) putUInt64(table, offsets[i]);
+        if (!table.empty()) {
+            ok = std::fseek(file, static_cast<long>(tableOffset), SEEK_SET) == 0 && ok;
+            ok = std::fwrite(&table[0], 1, table.size(), file) == table.size() && ok;
+        }
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::string filename;
+    Compression compression;
+    FILE* file;
+    int width;
+    int height;
+    int nextBlock;                                  // Próximo bloco a gravar
+    size_t tableOffset;                             // Posição da tabela de deslocamentos
+    std::vector<uint64_t> offsets;
+    std::vector<std::vector<unsigned char>> blocks;
+
+    int linesPerBlock() const { return compression == Zip ? 16 : 1; }
+    int blockCount() const { return (height + linesPerBlock() - 1) / linesPerBlock(); }
+
+    // Dados de um bloco: para cada linha, os canais B, G e R em sequência
+    void packBlock(const Framebuffer& image, int block, std::vector<unsigned char>& out) const {
+        int y0 = block * linesPerBlock();
+        int y1 = std::min(y0 + linesPerBlock(), height);
+        std::vector<unsigned char> raw;
+        raw.reserve(static_cast<size_t>(y1 - y0) * width * 3 * sizeof(float));
+        for (int y = y0; y < y1; y++) {
+            const float* row = image.row(Framebuffer::Radiance, y);
+            for (int c = 2; c >= 0; c--) {
+                for (int x = 0; x < width; x++) putFloat(raw, row[x * 3 + c]);
+            }
+        }
+
+        if (compression == None) {
+            out.swap(raw);
+            return;
+        }
+
+        // ZIP: bytes separados em duas metades (pares e ímpares), codificados
+        // por diferença e comprimidos com zlib
+        size_t size = raw.size();
+        std::vector<unsigned char> shuffled(size);
+        size_t half = (size + 1) / 2;
+        for (size_t i = 0; i < size; i++) {
+            shuffled[(i & 1) ? half + i / 2 : i / 2] = raw[i];
+        }
+        int previous = size > 0 ? shuffled[0] : 0;
+        for (size_t i = 1; i < size; i++) {
+            int current = shuffled[i];
+            shuffled[i] = static_cast<unsigned char>(current - previous + 128);
+            previous = current;
+        }
+
+        out.clear();
+        Deflate::zlibCompress(size > 0 ? &shuffled[0] : nullptr, size, out);
+        if (out.size() >= size) out.swap(raw);  // Blocos incompressíveis ficam sem compressão
+    }
+
+    static void putUInt32(std::vector<unsigned char>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+
+    static void putUInt64(std::vector<unsigned char>& out, uint64_t value) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+
+    static void putFloat(std::vector<unsigned char>& out, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putUInt32(out, bits);
+    }
+
+    static void putAttribute(std::vector<unsigned char>& out, const char* name, const char* type,
+                             const std::vector<unsigned char>& value) {
+        out.insert(out.end(), name, name + std::strlen(name) + 1);
+        out.insert(out.end(), type, type + std::strlen(type) + 1);
+        putUInt32(out, static_cast<uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+};
+
+#endif // EXR_WRITER_H
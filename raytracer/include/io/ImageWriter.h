@@ -0,0 +1,63 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "../core/Framebuffer.h"
+
+// Interface para escrita incremental de imagens. As linhas são entregues em
+// ordem, de cima para baixo, em blocos [y0, y1); isso permite gravar a imagem
+// enquanto a renderização ainda está em andamento.
+class ImageWriter {
+public:
+    virtual ~ImageWriter() = default;
+
+    // Abre o destino e escreve o cabeçalho
+    virtual bool begin(int width, int height) = 0;
+
+    // Escreve as linhas [y0, y1) do canal de radiância
+    virtual bool writeRows(const Framebuffer& image, int y0, int y1) = 0;
+
+    // Finaliza e fecha o destino
+    virtual bool end() = 0;
+
+    // Escreve uma imagem completa em blocos de linhas
+    bool write(const Framebuffer& image, int rowsPerBlock = 64) {
+        if (!begin(image.getWidth(), image.getHeight())) return false;
+        for (int y = 0; y < image.getHeight(); y += rowsPerBlock) {
+            if (!writeRows(image, y, std::min(y + rowsPerBlock, image.getHeight()))) return false;
+        }
+        return end();
+    }
+
+protected:
+    // Formatos de ponto flutuante (PFM, EXR) gravam os floats em little-endian
+    static bool isLittleEndian() {
+        uint16_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    // Converte as linhas [y0, y1) para RGB de 8 bits, com mapeamento de tons
+    // ou (toneMapped falso) apenas limitando os valores a [0, 1]
+    static void toRGB8(const Framebuffer& image, int y0, int y1, float exposure,
+                       std::vector<unsigned char>& out, bool toneMapped = true) {
+        int width = image.getWidth();
+        out.resize(static_cast<size_t>(y1 - y0) * width * 3);
+        unsigned char* p = out.empty() ? nullptr : &out[0];
+        for (int y = y0; y < y1; y++) {
+            for (int x = 0; x < width; x++) {
+                Color pixel = image.getColor(Framebuffer::Radiance, x, y);
+                if (toneMapped) pixel = toneMap(pixel, exposure);
+                *p++ = pixel.getR255();
+                *p++ = pixel.getG255();
+                *p++ = pixel.getB255();
+            }
+        }
+    }
+};
+
+#endif // IMAGE_WRITER_H
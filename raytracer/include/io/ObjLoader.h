@@ -0,0 +1,255 @@
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include "../geometry/TriangleMesh.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define OBJ_LOADER_USE_MMAP 1
+#endif
+
+// Arquivo somente leitura mapeado em memória. Em plataformas sem mmap,
+// o conteúdo é lido para um buffer em blocos grandes.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) : data_(nullptr), size_(0), mapped_(false) {
+#ifdef OBJ_LOADER_USE_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(p);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+            }
+        }
+        ::close(fd);
+        if (mapped_) return;
+#endif
+        FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) return;
+        const size_t chunkSize = 1 << 20;
+        size_t read;
+        do {
+            buffer_.resize(buffer_.size() + chunkSize);
+            read = std::fread(&buffer_[buffer_.size() - chunkSize], 1, chunkSize, file);
+            buffer_.resize(buffer_.size() - chunkSize + read);
+        } while (read == chunkSize);
+        std::fclose(file);
+        data_ = buffer_.empty() ? "" : &buffer_[0];
+        size_ = buffer_.size();
+    }
+
+    ~MappedFile() {
+#ifdef OBJ_LOADER_USE_MMAP
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+    const char* data_;
+    size_t size_;
+    bool mapped_;
+    std::vector<char> buffer_;
+};
+
+// Leitor de arquivos Wavefront OBJ. Lê posições (v), normais (vn) e faces (f);
+// polígonos são triangulados em leque. As demais diretivas são ignoradas.
+// O arquivo é percorrido uma única vez diretamente sobre a memória mapeada.
+class ObjLoader {
+public:
+    // Carrega a malha do arquivo. Retorna nullptr em caso de erro.
+    static std::shared_ptr<MeshData> load(const std::string& filename) {
+        MappedFile file(filename);
+        if (!file.isOpen()) {
+            std::cerr << "Erro: não foi possível abrir " << filename << std::endl;
+            return std::shared_ptr<MeshData>();
+        }
+
+        std::shared_ptr<MeshData> mesh = std::make_shared<MeshData>();
+        const char* p = file.data();
+        const char* end = p + file.size();
+        bool allFacesHaveNormals = true;
+        int lineNumber = 0;
+
+        // Índices do polígono corrente (reutilizados entre faces)
+        std::vector<long> facePositions;
+        std::vector<long> faceNormals;
+
+        while (p < end) {
+            lineNumber++;
+            p = skipSpaces(p, end);
+
+            if (p + 1 < end && p[0] == 'v' && isSpace(p[1])) {
+                Vector3 v;
+                p = parseFloat(p + 2, end, v.x);
+                p = parseFloat(p, end, v.y);
+                p = parseFloat(p, end, v.z);
+                mesh->positions.push_back(v);
+            } else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && isSpace(p[2])) {
+                Vector3 n;
+                p = parseFloat(p + 3, end, n.x);
+                p = parseFloat(p, end, n.y);
+                p = parseFloat(p, end, n.z);
+                mesh->normals.push_back(n);
+            } else if (p + 1 < end && p[0] == 'f' && isSpace(p[1])) {
+                p = parseFace(p + 2, end, facePositions, faceNormals);
+
+                if (facePositions.size() < 3 ||
+                    !resolveIndices(facePositions, mesh->positions.size()) ||
+                    (!faceNormals.empty() && !resolveIndices(faceNormals, mesh->normals.size()))) {
+                    std::cerr << "Erro: face inválida em " << filename << ":" << lineNumber << std::endl;
+                    return std::shared_ptr<MeshData>();
+                }
+                if (faceNormals.size() != facePositions.size()) {
+                    allFacesHaveNormals = false;
+                }
+
+                // Triangulação em leque
+                for (size_t i = 1; i + 1 < facePositions.size(); i++) {
+                    mesh->indices.push_back(static_cast<unsigned int>(facePositions[0]));
+                    mesh->indices.push_back(static_cast<unsigned int>(facePositions[i]));
+                    mesh->indices.push_back(static_cast<unsigned int>(facePositions[i + 1]));
+                    if (allFacesHaveNormals) {
+                        mesh->normalIndices.push_back(static_cast<unsigned int>(faceNormals[0]));
+                        mesh->normalIndices.push_back(static_cast<unsigned int>(faceNormals[i]));
+                        mesh->normalIndices.push_back(static_cast<unsigned int>(faceNormals[i + 1]));
+                    }
+                }
+            }
+
+            p = skipLine(p, end);
+        }
+
+        // Normais só são usadas se todas as faces as definirem
+        if (!allFacesHaveNormals) {
+            mesh->normals.clear();
+            mesh->normalIndices.clear();
+        }
+
+        // Liberar a capacidade excedente dos vetores
+        std::vector<Vector3>(mesh->positions).swap(mesh->positions);
+        std::vector<Vector3>(mesh->normals).swap(mesh->normals);
+        std::vector<unsigned int>(mesh->indices).swap(mesh->indices);
+        std::vector<unsigned int>(mesh->normalIndices).swap(mesh->normalIndices);
+
+        return mesh;
+    }
+
+private:
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) p++;
+        return p;
+    }
+
+    static const char* skipLine(const char* p, const char* end) {
+        while (p < end && *p != '\n') p++;
+        return p < end ? p + 1 : p;
+    }
+
+    // Conversão de texto para float sem dependência de locale
+    static const char* parseFloat(const char* p, const char* end, float& value) {
+        p = skipSpaces(p, end);
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+        double result = 0.0;
+        while (p < end && *p >= '0' && *p <= '9') result = result * 10.0 + (*p++ - '0');
+
+        if (p < end && *p == '.') {
+            p++;
+            double scale = 0.1;
+            while (p < end && *p >= '0' && *p <= '9') {
+                result += (*p++ - '0') * scale;
+                scale *= 0.1;
+            }
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            bool negativeExp = false;
+            if (p < end && (*p == '-' || *p == '+')) negativeExp = (*p++ == '-');
+            int exponent = 0;
+            while (p < end && *p >= '0' && *p <= '9') exponent = exponent * 10 + (*p++ - '0');
+            result *= std::pow(10.0, negativeExp ? -exponent : exponent);
+        }
+
+        value = static_cast<float>(negative ? -result : result);
+        return p;
+    }
+
+    static const char* parseInt(const char* p, const char* end, long& value) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+        long result = 0;
+        while (p < end && *p >= '0' && *p <= '9') result = result * 10 + (*p++ - '0');
+        value = negative ? -result : result;
+        return p;
+    }
+
+    // Lê os vértices de uma face nos formatos v, v/vt, v//vn e v/vt/vn
+    static const char* parseFace(const char* p, const char* end,
+                                 std::vector<long>& positions, std::vector<long>& normals) {
+        positions.clear();
+        normals.clear();
+
+        while (true) {
+            p = skipSpaces(p, end);
+            if (p >= end || *p == '\n' || *p == '#') break;
+
+            long index = 0;
+            const char* start = p;
+            p = parseInt(p, end, index);
+            if (p == start) break;  // Token inesperado
+            positions.push_back(index);
+
+            if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/') {
+                    long texcoord;
+                    p = parseInt(p, end, texcoord);  // Coordenada de textura ignorada
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    p = parseInt(p, end, index);
+                    normals.push_back(index);
+                }
+            }
+        }
+        return p;
+    }
+
+    // Converte índices do OBJ (a partir de 1, ou negativos relativos ao fim)
+    // para índices a partir de 0, validando o intervalo
+    static bool resolveIndices(std::vector<long>& indices, size_t count) {
+        for (size_t i = 0; i < indices.size(); i++) {
+            long index = indices[i] > 0 ? indices[i] - 1 : static_cast<long>(count) + indices[i];
+            if (indices[i] == 0 || index < 0 || index >= static_cast<long>(count)) return false;
+            indices[i] = index;
+        }
+        return true;
+    }
+};
+
+#endif // OBJ_LOADER_H
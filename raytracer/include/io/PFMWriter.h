@@ -0,0 +1,72 @@
+#ifndef PFM_WRITER_H
+#define PFM_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <iostream>
+#include "ImageWriter.h"
+
+// Escrita de imagens PFM (Portable Float Map) com os valores lineares do
+// Framebuffer, sem mapeamento de tons. Canais RGB geram "PF" e canais
+// escalares (profundidade, variância...) geram "Pf". O formato guarda as
+// linhas de baixo para cima, então cada bloco é gravado direto na sua posição
+// final do arquivo.
+class PFMWriter : public ImageWriter {
+public:
+    PFMWriter(const std::string& filename, Framebuffer::Channel channel = Framebuffer::Radiance)
+        : filename(filename), channel(channel), file(nullptr), width(0), height(0), dataOffset(0) {}
+
+    virtual ~PFMWriter() {
+        if (file) std::fclose(file);
+    }
+
+    virtual bool begin(int imageWidth, int imageHeight) override {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Erro: não foi possível criar " << filename << std::endl;
+            return false;
+        }
+        width = imageWidth;
+        height = imageHeight;
+
+        // Escala negativa indica little-endian
+        int n = std::fprintf(file, "%s\n%d %d\n%s\n", Framebuffer::components(channel) == 3 ? "PF" : "Pf",
+                             width, height, isLittleEndian() ? "-1.0" : "1.0");
+        dataOffset = n > 0 ? n : 0;
+        return n > 0;
+    }
+
+    virtual bool writeRows(const Framebuffer& image, int y0, int y1) override {
+        if (!file) return false;
+        if (!image.hasChannel(channel)) {
+            std::cerr << "Erro: canal ausente no Framebuffer para " << filename << std::endl;
+            return false;
+        }
+
+        size_t rowFloats = static_cast<size_t>(width) * Framebuffer::components(channel);
+        for (int y = y1 - 1; y >= y0; y--) {
+            // A linha y (a partir do topo) é a linha height - 1 - y do arquivo
+            long offset = static_cast<long>(dataOffset + (height - 1 - y) * rowFloats * sizeof(float));
+            if (std::fseek(file, offset, SEEK_SET) != 0) return false;
+            if (std::fwrite(image.row(channel, y), sizeof(float), rowFloats, file) != rowFloats) return false;
+        }
+        return true;
+    }
+
+    virtual bool end() override {
+        if (!file) return false;
+        bool ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::string filename;
+    Framebuffer::Channel channel;
+    FILE* file;
+    int width;
+    int height;
+    size_t dataOffset;      // Tamanho do cabeçalho em bytes
+};
+
+#endif // PFM_WRITER_H
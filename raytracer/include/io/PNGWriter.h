@@ -0,0 +1,221 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <iostream>
+#include "ImageWriter.h"
+#include "Deflate.h"
+
+// Escrita de imagens PNG (RGB de 8 bits) sem dependências externas. Cada bloco
+// de linhas é filtrado e dividido em faixas de StripRows linhas, comprimidas
+// em paralelo de forma independente; as faixas são concatenadas num único
+// fluxo zlib e gravadas como chunks IDAT à medida que chegam.
+class PNGWriter : public ImageWriter {
+public:
+    static const int StripRows = 16;
+
+    // Com toneMapped falso, a radiância é gravada como cor de exibição (mapas
+    // de calor, AOVs já normalizados)
+    PNGWriter(const std::string& filename, float exposure = 1.2f, bool toneMapped = true)
+        : filename(filename), exposure(exposure), toneMapped(toneMapped), file(nullptr), width(0),
+          adler(1), headerPending(false) {}
+
+    virtual ~PNGWriter() {
+        if (file) std::fclose(file);
+    }
+
+    virtual bool begin(int imageWidth, int imageHeight) override {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Erro: não foi possível criar " << filename << std::endl;
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+        static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        std::fwrite(signature, 1, sizeof(signature), file);
+
+        std::vector<unsigned char> ihdr;
+        putUInt32(ihdr, static_cast<uint32_t>(imageWidth));
+        putUInt32(ihdr, static_cast<uint32_t>(imageHeight));
+        ihdr.push_back(8);   // Bits por canal
+        ihdr.push_back(2);   // RGB
+        ihdr.push_back(0);   // Compressão deflate
+        ihdr.push_back(0);   // Filtragem adaptativa
+        ihdr.push_back(0);   // Sem entrelaçamento
+        writeChunk("IHDR", ihdr);
+
+        width = imageWidth;
+        adler = 1;
+        headerPending = true;
+        previousRow.assign(static_cast<size_t>(width) * 3, 0);
+        return true;
+    }
+
+    virtual bool writeRows(const Framebuffer& image, int y0, int y1) override {
+        if (!file) return false;
+        int rows = y1 - y0;
+        if (rows <= 0) return true;
+
+        toRGB8(image, y0, y1, exposure, bytes, toneMapped);
+        size_t rowBytes = static_cast<size_t>(width) * 3;
+        size_t filteredRowBytes = rowBytes + 1;
+        filtered.resize(filteredRowBytes * rows);
+
+        // Filtragem por linha (cada linha só depende da anterior já convertida)
+        #pragma omp parallel for schedule(static)
+        for (int r = 0; r < rows; r++) {
+            const unsigned char* current = &bytes[r * rowBytes];
+            const unsigned char* above = r > 0 ? &bytes[(r - 1) * rowBytes] : &previousRow[0];
+            filterRow(current, above, rowBytes, &filtered[r * filteredRowBytes]);
+        }
+        std::copy(bytes.end() - rowBytes, bytes.end(), previousRow.begin());
+        adler = Deflate::adler32(adler, &filtered[0], filtered.size());
+
+        // Compressão das faixas em paralelo
+        int stripCount = (rows + StripRows - 1) / StripRows;
+        strips.resize(stripCount);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int s = 0; s < stripCount; s++) {
+            size_t begin = static_cast<size_t>(s) * StripRows * filteredRowBytes;
+            size_t end = std::min(begin + StripRows * filteredRowBytes, filtered.size());
+            strips[s].clear();
+            Deflate::compress(&filtered[begin], end - begin, strips[s], false);
+        }
+
+        data.clear();
+        if (headerPending) {
+            data.push_back(0x78);   // Cabeçalho zlib: deflate, janela de 32 KB
+            data.push_back(0x9c);
+            headerPending = false;
+        }
+        for (int s = 0; s < stripCount; s++) {
+            data.insert(data.end(), strips[s].begin(), strips[s].end());
+        }
+        return writeChunk("IDAT", data);
+    }
+
+    virtual bool end() override {
+        if (!file) return false;
+
+        // Bloco final vazio e Adler-32 encerram o fluxo zlib
+        data.clear();
+        if (headerPending) {
+            data.push_back(0x78);
+            data.push_back(0x9c);
+            headerPending = false;
+        }
+        Deflate::compress(nullptr, 0, data, true);
+        putUInt32(data, adler);
+        bool ok = writeChunk("IDAT", data);
+
+        data.clear();
+        ok = writeChunk("IEND", data) && ok;
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::string filename;
+    float exposure;
+    bool toneMapped;
+    FILE* file;
+    int width;
+    uint32_t adler;                             // Adler-32 acumulado dos dados filtrados
+    bool headerPending;                         // Cabeçalho zlib ainda não gravado
+    std::vector<unsigned char> previousRow;     // Última linha do bloco anterior
+    std::vector<unsigned char> bytes;           // Bloco convertido para 8 bits
+    std::vector<unsigned char> filtered;        // Bloco filtrado (byte de filtro + linha)
+    std::vector<std::vector<unsigned char>> strips;
+    std::vector<unsigned char> data;            // Conteúdo do chunk em montagem
+
+    static void putUInt32(std::vector<unsigned char>& out, uint32_t value) {
+        out.push_back(static_cast<unsigned char>(value >> 24));
+        out.push_back(static_cast<unsigned char>(value >> 16));
+        out.push_back(static_cast<unsigned char>(value >> 8));
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    struct CRCTable {
+        uint32_t entries[256];
+        CRCTable() {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                entries[n] = c;
+            }
+        }
+    };
+
+    static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size) {
+        static const CRCTable table;
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    bool writeChunk(const char* type, const std::vector<unsigned char>& payload) {
+        std::vector<unsigned char> header;
+        putUInt32(header, static_cast<uint32_t>(payload.size()));
+        header.insert(header.end(), type, type + 4);
+
+        uint32_t crc = crc32(0, reinterpret_cast<const unsigned char*>(type), 4);
+        if (!payload.empty()) crc = crc32(crc, &payload[0], payload.size());
+        std::vector<unsigned char> footer;
+        putUInt32(footer, crc);
+
+        bool ok = std::fwrite(&header[0], 1, header.size(), file) == header.size();
+        if (!payload.empty()) ok = std::fwrite(&payload[0], 1, payload.size(), file) == payload.size() && ok;
+        return std::fwrite(&footer[0], 1, footer.size(), file) == footer.size() && ok;
+    }
+
+    static int paeth(int a, int b, int c) {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return a;
+        return pb <= pc ? b : c;
+    }
+
+    // Escolhe o filtro com menor soma dos valores absolutos (heurística da libpng)
+    static void filterRow(const unsigned char* row, const unsigned char* above, size_t size, unsigned char* out) {
+        const size_t bpp = 3;
+
+        int bestFilter = 0;
+        uint64_t bestCost = ~0ULL;
+        for (int filter = 0; filter < 5; filter++) {
+            uint64_t cost = 0;
+            for (size_t i = 0; i < size && cost < bestCost; i++) {
+                int a = i >= bpp ? row[i - bpp] : 0;
+                int c = i >= bpp ? above[i - bpp] : 0;
+                signed char v = static_cast<signed char>(filterByte(filter, row[i], a, above[i], c));
+                cost += static_cast<uint64_t>(std::abs(static_cast<int>(v)));
+            }
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestFilter = filter;
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(bestFilter);
+        for (size_t i = 0; i < size; i++) {
+            int a = i >= bpp ? row[i - bpp] : 0;
+            int c = i >= bpp ? above[i - bpp] : 0;
+            out[i + 1] = filterByte(bestFilter, row[i], a, above[i], c);
+        }
+    }
+
+    static unsigned char filterByte(int filter, int x, int a, int b, int c) {
+        switch (filter) {
+            case 1: return static_cast<unsigned char>(x - a);
+            case 2: return static_cast<unsigned char>(x - b);
+            case 3: return static_cast<unsigned char>(x - ((a + b) >> 1));
+            case 4: return static_cast<unsigned char>(x - paeth(a, b, c));
+            default: return static_cast<unsigned char>(x);
+        }
+    }
+};
+
+#endif // PNG_WRITER_H
@@ -0,0 +1,67 @@
+#ifndef PPM_WRITER_H
+#define PPM_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <iostream>
+#include "ImageWriter.h"
+
+// Escrita de imagens PPM. O formato binário (P6) grava cada bloco de linhas
+// com uma única escrita; o formato ASCII (P3) é mantido por compatibilidade.
+class PPMWriter : public ImageWriter {
+public:
+    PPMWriter(const std::string& filename, float exposure = 1.2f, bool binary = true)
+        : filename(filename), exposure(exposure), binary(binary), file(nullptr) {}
+
+    virtual ~PPMWriter() {
+        if (file) std::fclose(file);
+    }
+
+    virtual bool begin(int width, int height) override {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Erro: não foi possível criar " << filename << std::endl;
+            return false;
+        }
+        // Buffer grande: cada bloco de linhas vira poucas chamadas ao sistema
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        std::fprintf(file, "%s\n%d %d\n255\n", binary ? "P6" : "P3", width, height);
+        return true;
+    }
+
+    virtual bool writeRows(const Framebuffer& image, int y0, int y1) override {
+        if (!file) return false;
+        toRGB8(image, y0, y1, exposure, bytes);
+        if (bytes.empty()) return true;
+
+        if (binary) {
+            return std::fwrite(&bytes[0], 1, bytes.size(), file) == bytes.size();
+        }
+
+        // P3: um pixel por linha de texto
+        text.clear();
+        char buffer[16];
+        for (size_t i = 0; i < bytes.size(); i += 3) {
+            int n = std::snprintf(buffer, sizeof(buffer), "%d %d %d\n", bytes[i], bytes[i + 1], bytes[i + 2]);
+            text.append(buffer, n);
+        }
+        return std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    }
+
+    virtual bool end() override {
+        if (!file) return false;
+        bool ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::string filename;
+    float exposure;
+    bool binary;
+    FILE* file;
+    std::vector<unsigned char> bytes;   // Bloco convertido para 8 bits
+    std::string text;                   // Bloco formatado (P3)
+};
+
+#endif // PPM_WRITER_H
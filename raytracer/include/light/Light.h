@@ -4,18 +4,34 @@
 #include "../core/Vector3.h"
 #include "../core/Color.h"
 
+// Amostra de uma fonte de luz vista a partir de um ponto iluminado. Todos os
+// campos se referem ao mesmo ponto da luz, então a direção e a distância do
+// raio de sombra sempre concordam.
+struct LightSample {
+    Vector3 position;    // Ponto amostrado na luz
+    Vector3 direction;   // Direção normalizada do ponto iluminado até a luz
+    float distance;      // Distância até o ponto amostrado
+    float pdf;           // Densidade da amostra por unidade de área (1 para luzes pontuais)
+    Color intensity;     // Intensidade que chega ao ponto iluminado
+};
+
+// Atenuação com a distância usada na iluminação direta, ajustada para a
+// iluminação suave das cenas de referência
+inline float lightAttenuation(float distance) {
+    return 1.0f / (1.0f + 0.09f * distance + 0.032f * distance * distance);
+}
+
 class Light {
 public:
     virtual ~Light() = default;
     
-    // Retorna a direção da luz a partir de um ponto
-    virtual Vector3 getDirection(const Vector3& point) const = 0;
-    
-    // Retorna a intensidade da luz em um ponto
-    virtual Color getIntensity(const Vector3& point) const = 0;
+    // Amostra a luz a partir de um ponto. (u1, u2) são números uniformes em
+    // [0, 1) fornecidos pelo chamador (normalmente por um Sampler); a luz não
+    // guarda estado, então pode ser amostrada por várias threads ao mesmo tempo.
+    virtual LightSample sample(const Vector3& point, float u1, float u2) const = 0;
     
-    // Retorna a distância do ponto até a luz
-    virtual float getDistance(const Vector3& point) const = 0;
+    // Número de amostras desejado por ponto iluminado
+    virtual int sampleCount() const { return 1; }
 };
 
-#endif // LIGHT_H 
\ No newline at end of file
+#endif // LIGHT_H
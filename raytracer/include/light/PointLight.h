@@ -14,20 +14,17 @@ public:
     PointLight(const Vector3& position, const Color& intensity)
         : position(position), intensity(intensity) {}
     
-    // Implementação dos métodos da interface Light
-    virtual Vector3 getDirection(const Vector3& point) const override {
-        return normalize(position - point);
-    }
-    
-    virtual Color getIntensity(const Vector3& point) const override {
-        float distance = (position - point).length();
-        // Sem atenuação por enquanto
-        return intensity;
-    }
-    
-    virtual float getDistance(const Vector3& point) const override {
-        return (position - point).length();
+    // Implementação dos métodos da interface Light (a posição é fixa, u1 e u2 são ignorados)
+    virtual LightSample sample(const Vector3& point, float /*u1*/, float /*u2*/) const override {
+        LightSample s;
+        Vector3 toLight = position - point;
+        s.position = position;
+        s.distance = toLight.length();
+        s.direction = toLight / s.distance;
+        s.pdf = 1.0f;
+        s.intensity = intensity;  // Sem atenuação por enquanto
+        return s;
     }
 };
 
-#endif // POINT_LIGHT_H 
\ No newline at end of file
+#endif // POINT_LIGHT_H
@@ -0,0 +1,52 @@
+#ifndef DIELECTRIC_MATERIAL_H
+#define DIELECTRIC_MATERIAL_H
+
+#include "Material.h"
+
+// Material transparente (vidro, água): em cada ponto o raio é refletido ou
+// refratado. Em vez de seguir os dois raios (árvore de raios que dobra a
+// cada interface), o núcleo de espalhamento sorteia um deles com a
+// probabilidade dada pela refletância de Fresnel, o que mantém um único raio
+// por caminho com o mesmo valor esperado.
+class DielectricMaterial : public Material {
+public:
+    Color tint;             // Cor transmitida/refletida a cada interface
+    float refractiveIndex;  // Índice de refração (1.5 para vidro)
+
+    // Sem luz ambiente nem difusa; "specular" e "shininess" dão o brilho das luzes
+    DielectricMaterial(const Color& tint, float refractiveIndex, const Color& specular = Color(0, 0, 0),
+                       float shininess = 0.0f)
+        : Material(Color(0, 0, 0), Color(0, 0, 0), specular, shininess, MaterialType::Dielectric),
+          tint(tint), refractiveIndex(refractiveIndex) {}
+
+    // Escolhe entre reflexão e refração com o número "u" em [0, 1). A normal
+    // do registro aponta contra o raio; frontFace indica se o raio está
+    // entrando no material.
+    Ray scatteredRay(const Ray& ray, const HitRecord& record, float u) const {
+        Vector3 d = normalize(ray.direction);
+        float eta = record.frontFace ? 1.0f / refractiveIndex : refractiveIndex;
+        float cosI = std::min(-dot(d, record.normal), 1.0f);
+        float sin2T = eta * eta * (1.0f - cosI * cosI);
+
+        // Reflexão interna total ou sorteio pela refletância
+        if (sin2T >= 1.0f || u < reflectance(cosI, eta)) {
+            Vector3 reflected = d - record.normal * (2.0f * dot(d, record.normal));
+            return Ray(record.point + record.normal * 0.001f, reflected);
+        }
+
+        float cosT = std::sqrt(1.0f - sin2T);
+        Vector3 refracted = d * eta + record.normal * (eta * cosI - cosT);
+        return Ray(record.point - record.normal * 0.001f, refracted);
+    }
+
+private:
+    // Aproximação de Schlick para a refletância de Fresnel
+    static float reflectance(float cosine, float eta) {
+        float r0 = (1.0f - eta) / (1.0f + eta);
+        r0 = r0 * r0;
+        float m = 1.0f - cosine;
+        return r0 + (1.0f - r0) * m * m * m * m * m;
+    }
+};
+
+#endif // DIELECTRIC_MATERIAL_H
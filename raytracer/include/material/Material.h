@@ -0,0 +1,73 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <cmath>
+#include <algorithm>
+#include "../core/Color.h"
+#include "../core/Ray.h"
+#include "../geometry/Primitive.h"
+
+// Tipo concreto do material. Os integradores escolhem o núcleo de
+// espalhamento pela tabela em MaterialKernels.h usando este valor, sem
+// dynamic_cast; cada subclasse define o seu no construtor.
+enum class MaterialType : unsigned char {
+    Phong,          // Material (apenas luz direta)
+    Reflective,     // ReflectiveMaterial
+    Dielectric,     // DielectricMaterial
+    Count
+};
+
+class Material {
+public:
+    Color ambient;
+    Color diffuse;
+    Color specular;
+    float shininess;
+    const MaterialType type;    // Fixo na construção: a tabela de núcleos converte pelo tipo
+
+    Material() : Material(Color(0.1f, 0.1f, 0.1f), Color(0.7f, 0.7f, 0.7f), Color(0, 0, 0), 0, MaterialType::Phong) {}
+    Material(const Color& ambient, const Color& diffuse, const Color& specular, float shininess)
+        : Material(ambient, diffuse, specular, shininess, MaterialType::Phong) {}
+    virtual ~Material() = default;
+
+    virtual Color shade(const Ray& ray, const HitRecord& record, const Vector3& lightDir, const Color& lightIntensity) const {
+        float nDotL = std::max(0.0f, dot(record.normal, lightDir));
+        Color color = diffuse * lightIntensity * nDotL;
+        if (shininess > 0.0f && nDotL > 0.0f) {
+            Vector3 viewDir = normalize(-ray.direction);
+            Vector3 reflectDir = record.normal * (2.0f * nDotL) - lightDir;
+            float spec = std::pow(std::max(0.0f, dot(viewDir, reflectDir)), shininess);
+            color += specular * lightIntensity * spec;
+        }
+        return color;
+    }
+
+    // Mesmo modelo de shade para um pacote: raios, normais, direções e
+    // intensidades da luz por lane. Subclasses que sobrescrevem shade
+    // devem sobrescrever também esta versão.
+    virtual PacketColor shade(const PacketVec3& rayDirection, const PacketVec3& normal, const PacketVec3& lightDir,
+                              const PacketColor& lightIntensity) const {
+        PacketFloat zero(0.0f);
+        PacketFloat nDotL = max(dot(normal, lightDir), zero);
+        PacketColor color = PacketColor(diffuse) * lightIntensity * nDotL;
+        if (shininess > 0.0f) {
+            PacketVec3 viewDir = normalize(-rayDirection);
+            PacketVec3 reflectDir = normal * (nDotL * PacketFloat(2.0f)) - lightDir;
+            
+            // Sem potência vetorial: o expoente é aplicado lane a lane
+            float cosines[PacketSize];
+            max(dot(viewDir, reflectDir), zero).store(cosines);
+            for (int lane = 0; lane < PacketSize; lane++) cosines[lane] = std::pow(cosines[lane], shininess);
+            PacketFloat spec = select(nDotL > zero, PacketFloat::load(cosines), zero);
+            color += PacketColor(specular) * lightIntensity * spec;
+        }
+        return color;
+    }
+
+protected:
+    // Único construtor que define o tipo, usado pelas subclasses
+    Material(const Color& ambient, const Color& diffuse, const Color& specular, float shininess, MaterialType type)
+        : ambient(ambient), diffuse(diffuse), specular(specular), shininess(shininess), type(type) {}
+};
+
+#endif // MATERIAL_H
@@ -0,0 +1,63 @@
+#ifndef MATERIAL_KERNELS_H
+#define MATERIAL_KERNELS_H
+
+#include "Material.h"
+#include "ReflectiveMaterial.h"
+#include "DielectricMaterial.h"
+
+// Continuação de um caminho num ponto atingido: a luz direta do ponto entra
+// com peso directWeight e, se hasRay, o raio secundário "ray" contribui com
+// peso "weight". O integrador é quem traça o raio (sem recursão escondida
+// em callbacks). Cada ponto gera no máximo um raio: materiais com mais de
+// uma direção (reflexão e refração) sorteiam uma delas.
+struct Scatter {
+    float directWeight;
+    bool hasRay;
+    Ray ray;
+    Color weight;
+};
+
+// Núcleos de espalhamento, um por MaterialType. Cada um recebe o material já
+// identificado pelo tipo, então a conversão é um static_cast. "u" é um
+// número em [0, 1) do Sampler para os materiais que sorteiam a direção.
+typedef void (*ScatterKernel)(const Material& material, const Ray& ray, const HitRecord& record, float u,
+                              Scatter& result);
+
+inline void scatterPhong(const Material&, const Ray&, const HitRecord&, float, Scatter& result) {
+    result.directWeight = 1.0f;
+    result.hasRay = false;
+    result.weight = Color(0.0f, 0.0f, 0.0f);
+}
+
+inline void scatterReflective(const Material& material, const Ray& ray, const HitRecord& record, float,
+                              Scatter& result) {
+    const ReflectiveMaterial& reflective = static_cast<const ReflectiveMaterial&>(material);
+    float r = reflective.reflectivity;
+    result.directWeight = 1.0f - r;
+    result.hasRay = true;
+    result.ray = ReflectiveMaterial::reflectedRay(ray, record);
+    result.weight = Color(r, r, r);
+}
+
+inline void scatterDielectric(const Material& material, const Ray& ray, const HitRecord& record, float u,
+                              Scatter& result) {
+    const DielectricMaterial& dielectric = static_cast<const DielectricMaterial&>(material);
+    result.directWeight = 1.0f;
+    result.hasRay = true;
+    result.ray = dielectric.scatteredRay(ray, record, u);
+    result.weight = dielectric.tint;
+}
+
+// Despacha para o núcleo do tipo do material (tabela indexada pelo tipo)
+inline Scatter scatter(const Material& material, const Ray& ray, const HitRecord& record, float u) {
+    static const ScatterKernel kernels[static_cast<int>(MaterialType::Count)] = {
+        scatterPhong,       // MaterialType::Phong
+        scatterReflective,  // MaterialType::Reflective
+        scatterDielectric   // MaterialType::Dielectric
+    };
+    Scatter result;
+    kernels[static_cast<int>(material.type)](material, ray, record, u, result);
+    return result;
+}
+
+#endif // MATERIAL_KERNELS_H
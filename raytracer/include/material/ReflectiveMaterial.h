@@ -0,0 +1,22 @@
+#ifndef REFLECTIVE_MATERIAL_H
+#define REFLECTIVE_MATERIAL_H
+
+#include "Material.h"
+
+class ReflectiveMaterial : public Material {
+public:
+    float reflectivity;
+
+    ReflectiveMaterial(const Color& ambient, const Color& diffuse, const Color& specular,
+                       float shininess, float reflectivity)
+        : Material(ambient, diffuse, specular, shininess, MaterialType::Reflective), reflectivity(reflectivity) {}
+
+    // Raio refletido no ponto de interseção, deslocado ao longo da normal
+    static Ray reflectedRay(const Ray& ray, const HitRecord& record) {
+        Vector3 d = normalize(ray.direction);
+        Vector3 reflected = d - record.normal * (2.0f * dot(d, record.normal));
+        return Ray(record.point + record.normal * 0.001f, reflected);
+    }
+};
+
+#endif // REFLECTIVE_MATERIAL_H
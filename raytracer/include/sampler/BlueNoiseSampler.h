@@ -0,0 +1,138 @@
+#ifndef BLUE_NOISE_SAMPLER_H
+#define BLUE_NOISE_SAMPLER_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Sampler.h"
+#include "SobolSampler.h"
+
+// Amostras com erro distribuído como ruído azul entre pixels vizinhos
+// (Heitz e Belcour, 2019). Todos os pixels percorrem a mesma sequência de
+// Sobol embaralhada, deslocada (módulo 1) por um valor de uma máscara de
+// ruído azul de 64x64 pixels repetida pela imagem. Cada dimensão lê a
+// máscara com um deslocamento diferente. Com poucas amostras por pixel, o
+// ruído restante fica em altas frequências, menos visível e mais fácil de
+// filtrar que o ruído branco.
+class BlueNoiseSampler : public Sampler {
+public:
+    static const int MaskSize = 64;
+
+    explicit BlueNoiseSampler(uint32_t seed = 0) : sequence(seed), seed(seed) {}
+
+    virtual float get(int x, int y, uint32_t index, uint32_t dimension) const override {
+        static const Mask mask;
+
+        // Mesma sequência para todos os pixels
+        float value = sequence.get(0, 0, index, dimension);
+
+        uint32_t offset = SobolSampler::hashCombine(seed, dimension);
+        int mx = (x + static_cast<int>(offset & (MaskSize - 1))) & (MaskSize - 1);
+        int my = (y + static_cast<int>((offset >> 8) & (MaskSize - 1))) & (MaskSize - 1);
+        value += mask.values[my * MaskSize + mx];
+        return value >= 1.0f ? value - 1.0f : value;
+    }
+
+private:
+    SobolSampler sequence;
+    uint32_t seed;
+
+    // Máscara de ruído azul gerada pelo método void-and-cluster (Ulichney,
+    // 1993) com filtro gaussiano toroidal. É calculada uma única vez, na
+    // primeira consulta; o resultado é determinístico.
+    struct Mask {
+        static const int Count = MaskSize * MaskSize;
+        float values[Count];
+
+        Mask() {
+            const float sigma = 1.5f;
+            kernel.resize(Count);
+            for (int dy = 0; dy < MaskSize; dy++) {
+                for (int dx = 0; dx < MaskSize; dx++) {
+                    int tx = std::min(dx, MaskSize - dx);
+                    int ty = std::min(dy, MaskSize - dy);
+                    kernel[dy * MaskSize + dx] = std::exp(-(tx * tx + ty * ty) / (2.0f * sigma * sigma));
+                }
+            }
+
+            // Padrão inicial: 10% dos pixels, redistribuídos até estabilizar
+            std::vector<char> pattern(Count, 0);
+            std::vector<float> energy(Count, 0.0f);
+            int ones = Count / 10;
+            RNG rng(0x5eed, 0, 0);
+            for (int placed = 0; placed < ones;) {
+                int p = static_cast<int>(rng.nextUInt() % Count);
+                if (pattern[p]) continue;
+                toggle(pattern, energy, p);
+                placed++;
+            }
+            for (int iteration = 0; iteration < Count; iteration++) {
+                int cluster = tightestCluster(pattern, energy);
+                toggle(pattern, energy, cluster);
+                int hole = largestVoid(pattern, energy);
+                if (hole == cluster) {
+                    toggle(pattern, energy, cluster);
+                    break;
+                }
+                toggle(pattern, energy, hole);
+            }
+
+            std::vector<int> rank(Count, 0);
+
+            // Fase 1: remove os aglomerados do padrão inicial, do posto mais alto ao mais baixo
+            std::vector<char> reduced(pattern);
+            std::vector<float> reducedEnergy(energy);
+            for (int r = ones - 1; r >= 0; r--) {
+                int cluster = tightestCluster(reduced, reducedEnergy);
+                toggle(reduced, reducedEnergy, cluster);
+                rank[cluster] = r;
+            }
+
+            // Fase 2: preenche os maiores vazios até completar a máscara
+            for (int r = ones; r < Count; r++) {
+                int hole = largestVoid(pattern, energy);
+                toggle(pattern, energy, hole);
+                rank[hole] = r;
+            }
+
+            for (int p = 0; p < Count; p++) {
+                values[p] = (rank[p] + 0.5f) / Count;
+            }
+        }
+
+    private:
+        std::vector<float> kernel;
+
+        // Liga/desliga o pixel p e atualiza a energia de todos os pixels
+        void toggle(std::vector<char>& pattern, std::vector<float>& energy, int p) const {
+            float sign = pattern[p] ? -1.0f : 1.0f;
+            pattern[p] = !pattern[p];
+            int px = p % MaskSize, py = p / MaskSize;
+            for (int qy = 0; qy < MaskSize; qy++) {
+                const float* row = &kernel[((qy - py) & (MaskSize - 1)) * MaskSize];
+                float* e = &energy[qy * MaskSize];
+                for (int qx = 0; qx < MaskSize; qx++) {
+                    e[qx] += sign * row[(qx - px) & (MaskSize - 1)];
+                }
+            }
+        }
+
+        static int tightestCluster(const std::vector<char>& pattern, const std::vector<float>& energy) {
+            int best = -1;
+            for (int p = 0; p < Count; p++) {
+                if (pattern[p] && (best < 0 || energy[p] > energy[best])) best = p;
+            }
+            return best;
+        }
+
+        static int largestVoid(const std::vector<char>& pattern, const std::vector<float>& energy) {
+            int best = -1;
+            for (int p = 0; p < Count; p++) {
+                if (!pattern[p] && (best < 0 || energy[p] < energy[best])) best = p;
+            }
+            return best;
+        }
+    };
+};
+
+#endif // BLUE_NOISE_SAMPLER_H
@@ -0,0 +1,86 @@
+#ifndef HALTON_SAMPLER_H
+#define HALTON_SAMPLER_H
+
+#include <algorithm>
+#include "Sampler.h"
+#include "SobolSampler.h"
+
+// Sequência de Halton: a dimensão d é o inverso radical do índice na base
+// do d-ésimo primo. Os dígitos são embaralhados à moda de Owen: cada dígito
+// passa por uma permutação aleatória que depende da dimensão, do pixel e dos
+// dígitos anteriores. Isso preserva a estratificação da sequência e elimina a
+// correlação entre as bases grandes vizinhas, que com poucas amostras deixa
+// os pontos de Halton quase alinhados. Dimensões além da tabela de primos
+// reutilizam as bases com outro embaralhamento.
+class HaltonSampler : public Sampler {
+public:
+    static const int PrimeCount = 32;
+
+    explicit HaltonSampler(uint32_t seed = 0) : seed(seed) {}
+
+    virtual float get(int x, int y, uint32_t index, uint32_t dimension) const override {
+        static const uint32_t primes[PrimeCount] = {
+            2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+            59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131
+        };
+        uint32_t base = primes[dimension % PrimeCount];
+        uint32_t scramble = SobolSampler::hashCombine(SobolSampler::pixelHash(seed, x, y), dimension);
+        return scrambledRadicalInverse(index, base, scramble);
+    }
+
+private:
+    uint32_t seed;
+
+    // Inverso radical com embaralhamento de Owen. Os dígitos nulos além do
+    // último dígito do índice também são permutados, até a precisão do float.
+    static float scrambledRadicalInverse(uint32_t index, uint32_t base, uint32_t scramble) {
+        const double invBase = 1.0 / base;
+        double factor = invBase;
+        double result = 0.0;
+        uint32_t prefix = scramble;
+        while (factor > 1e-8) {
+            uint32_t digit = index % base;
+            index /= base;
+            result += permute(digit, base, prefix) * factor;
+            prefix = SobolSampler::hashCombine(prefix, digit);
+            factor *= invBase;
+        }
+        return std::min(static_cast<float>(result), 0.99999994f);
+    }
+
+    // Elemento i de uma permutação pseudoaleatória de [0, n) escolhida por
+    // "seed" (Kensler, "Correlated Multi-Jittered Sampling", 2013). Cada passo
+    // é uma bijeção sobre os bits baixos; valores fora do intervalo são
+    // permutados de novo até caírem dentro dele.
+    static uint32_t permute(uint32_t i, uint32_t n, uint32_t seed) {
+        uint32_t w = n - 1;
+        w |= w >> 1;
+        w |= w >> 2;
+        w |= w >> 4;
+        w |= w >> 8;
+        w |= w >> 16;
+        do {
+            i ^= seed;
+            i *= 0xe170893du;
+            i ^= seed >> 16;
+            i ^= (i & w) >> 4;
+            i ^= seed >> 8;
+            i *= 0x0929eb3fu;
+            i ^= seed >> 23;
+            i ^= (i & w) >> 1;
+            i *= 1 | seed >> 27;
+            i *= 0x6935fa69u;
+            i ^= (i & w) >> 11;
+            i *= 0x74dcb303u;
+            i ^= (i & w) >> 2;
+            i *= 0x9e501cc3u;
+            i ^= (i & w) >> 2;
+            i *= 0xc860a3dfu;
+            i &= w;
+            i ^= i >> 5;
+        } while (i >= n);
+        return (i + seed) % n;
+    }
+};
+
+#endif // HALTON_SAMPLER_H
@@ -0,0 +1,24 @@
+#ifndef INDEPENDENT_SAMPLER_H
+#define INDEPENDENT_SAMPLER_H
+
+#include "Sampler.h"
+#include "../core/Random.h"
+
+// Amostras uniformes independentes em todas as dimensões. Serve de
+// referência: o erro cai com 1/sqrt(N), sem a vantagem da baixa discrepância.
+class IndependentSampler : public Sampler {
+public:
+    explicit IndependentSampler(uint32_t seed = 0) : seed(seed) {}
+
+    virtual float get(int x, int y, uint32_t index, uint32_t dimension) const override {
+        uint64_t pixel = (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
+        RNG rng(seed, pixel, index);
+        rng.setDimension(dimension);
+        return rng.nextFloat();
+    }
+
+private:
+    uint32_t seed;
+};
+
+#endif // INDEPENDENT_SAMPLER_H
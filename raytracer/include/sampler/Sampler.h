@@ -0,0 +1,57 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <cstdint>
+
+// Tipos de amostrador disponíveis no Renderer
+enum class SamplerType {
+    Independent,    // Números pseudoaleatórios independentes
+    Sobol,          // Sobol com embaralhamento de Owen
+    Halton,         // Halton com embaralhamento de dígitos
+    BlueNoise       // Sobol deslocado por uma máscara de ruído azul
+};
+
+// Gerador de amostras para a integração de Monte Carlo. Cada amostra de um
+// pixel é um ponto de muitas dimensões: o Renderer usa as dimensões 0 e 1
+// para a posição dentro do pixel, as seguintes para as luzes de área e, a
+// partir de PathDimensions, duas por profundidade para as decisões do
+// caminho (direção sorteada pelo material e roleta russa).
+// A interface não guarda estado: o valor depende apenas de (pixel, índice da
+// amostra, dimensão), de modo que a mesma instância pode ser consultada por
+// todas as threads e a imagem não depende da ordem de execução.
+class Sampler {
+public:
+    virtual ~Sampler() = default;
+
+    // Coordenada "dimension" da amostra "index" do pixel (x, y), em [0, 1)
+    virtual float get(int x, int y, uint32_t index, uint32_t dimension) const = 0;
+
+    // Par de dimensões consecutivas (dimension, dimension + 1)
+    void get2D(int x, int y, uint32_t index, uint32_t dimension, float& u, float& v) const {
+        u = get(x, y, index, dimension);
+        v = get(x, y, index, dimension + 1);
+    }
+
+protected:
+    // Converte os 24 bits mais significativos de um inteiro em [0, 1)
+    static float toUnitFloat(uint32_t bits) {
+        return (bits >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// Primeira dimensão das decisões do caminho (longe das dimensões das luzes)
+static const uint32_t PathDimensions = 1u << 16;
+
+// Amostra de pixel em andamento, usada para consultar o Sampler ao longo do caminho
+struct PixelSample {
+    const Sampler* sampler;
+    int x, y;
+    uint32_t index;
+
+    // Número para a decisão "decision" (0: direção, 1: roleta) na profundidade "depth"
+    float pathValue(int depth, int decision) const {
+        return sampler->get(x, y, index, PathDimensions + 2 * static_cast<uint32_t>(depth) + decision);
+    }
+};
+
+#endif // SAMPLER_H
@@ -0,0 +1,80 @@
+#ifndef SOBOL_SAMPLER_H
+#define SOBOL_SAMPLER_H
+
+#include "Sampler.h"
+#include "../core/Random.h"
+
+// Sequência de Sobol com embaralhamento de Owen baseado em hash (Burley,
+// "Practical Hash-based Owen Scrambling", 2020). Cada par de dimensões usa
+// as duas primeiras dimensões de Sobol, que formam uma sequência (0, 2) em
+// base 2: qualquer prefixo de 2^k amostras é estratificado em todas as
+// partições elementares do quadrado. Para mais dimensões, cada par recebe um
+// embaralhamento próprio dos índices, o que descorrelaciona os pares sem
+// precisar de tabelas de direção adicionais; cada dimensão e cada pixel
+// recebem um embaralhamento de Owen independente.
+class SobolSampler : public Sampler {
+public:
+    explicit SobolSampler(uint32_t seed = 0) : seed(seed) {}
+
+    virtual float get(int x, int y, uint32_t index, uint32_t dimension) const override {
+        uint32_t pixelSeed = pixelHash(seed, x, y);
+        uint32_t pairSeed = hashCombine(pixelSeed, dimension / 2);
+        uint32_t shuffled = nestedUniformScramble(index, pairSeed);
+        uint32_t value = sobol(shuffled, dimension & 1);
+        return toUnitFloat(nestedUniformScramble(value, hashCombine(pixelSeed, 0x9e3779b9u + dimension)));
+    }
+
+    // Ponto de Sobol não embaralhado (dimensão 0 ou 1), em ponto fixo de 32 bits
+    static uint32_t sobol(uint32_t index, uint32_t dimension) {
+        if (dimension == 0) return reverseBits(index);
+
+        // Dimensão 1: v_i = v_{i-1} ^ (v_{i-1} >> 1), com v_0 = 2^31
+        uint32_t result = 0;
+        uint32_t direction = 0x80000000u;
+        for (; index; index >>= 1) {
+            if (index & 1) result ^= direction;
+            direction ^= direction >> 1;
+        }
+        return result;
+    }
+
+    // Embaralhamento de Owen de um número em ponto fixo: cada bit é invertido
+    // conforme um hash dos bits mais significativos
+    static uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+        x = reverseBits(x);
+        x = laineKarrasPermutation(x, seed);
+        return reverseBits(x);
+    }
+
+    static uint32_t hashCombine(uint32_t a, uint32_t b) {
+        return static_cast<uint32_t>(mixBits((static_cast<uint64_t>(a) << 32) | b));
+    }
+
+    static uint32_t pixelHash(uint32_t seed, int x, int y) {
+        return hashCombine(seed, (static_cast<uint32_t>(y) << 16) ^ static_cast<uint32_t>(x));
+    }
+
+    static uint32_t reverseBits(uint32_t x) {
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+        x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+private:
+    uint32_t seed;
+
+    // Permutação em que cada bit só depende dos bits menos significativos
+    // (versão revisada de Burley para a permutação de Laine-Karras)
+    static uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed) {
+        x ^= x * 0x3d20adeau;
+        x += seed;
+        x *= (seed >> 16) | 1;
+        x ^= x * 0x05526c56u;
+        x ^= x * 0x53a22864u;
+        return x;
+    }
+};
+
+#endif // SOBOL_SAMPLER_H
@@ -0,0 +1,95 @@
+#ifndef AFFINE_TRANSFORM_H
+#define AFFINE_TRANSFORM_H
+
+#include "Transform.h"
+
+// Transformação afim geral guardada como matriz 3x4, com a inversa (para
+// levar os raios ao espaço do objeto) e a inversa transposta (para as
+// normais) pré-calculadas. Uma cadeia de Translate, Rotate e Scale vira um
+// único AffineTransform em Scene::build (collapse), trocando uma chamada
+// virtual e uma transformação por nível por uma multiplicação de matriz.
+// A cadeia original é guardada em "source": se ela for alterada (animação),
+// sync atualiza a matriz.
+class AffineTransform : public Transform {
+public:
+    AffineMatrix toWorld;       // Espaço do objeto para o espaço de fora
+    AffineMatrix toObject;      // Inversa
+    AffineMatrix normalMatrix;  // Inversa transposta (sem translação)
+    Primitive* source;          // Cadeia reduzida por collapse (nulo se criado diretamente)
+    
+    AffineTransform(Primitive* object, const AffineMatrix& toWorld, Primitive* source = nullptr)
+        : Transform(object), source(source) {
+        setMatrix(toWorld);
+    }
+    
+    // Substitui uma cadeia de duas ou mais transformações por um novo
+    // AffineTransform com a matriz composta, que passa a ser do chamador;
+    // outros objetos são devolvidos sem alteração
+    static Primitive* collapse(Primitive* object) {
+        Primitive* leaf = object;
+        int length;
+        AffineMatrix composed = composeChain(leaf, &length);
+        if (length < 2) return object;
+        return new AffineTransform(leaf, composed, object);
+    }
+    
+    void setMatrix(const AffineMatrix& matrix) {
+        toWorld = matrix;
+        toObject = matrix.inverse();
+        for (int i = 0; i < 3; i++) {
+            normalMatrix.rows[i] = Vector3(toObject.rows[0][i], toObject.rows[1][i], toObject.rows[2][i]);
+        }
+    }
+    
+    // Recompõe a matriz a partir da cadeia original; retorna true se ela mudou
+    bool sync() {
+        if (!source) return false;
+        Primitive* leaf = source;
+        AffineMatrix composed = composeChain(leaf);
+        if (composed == toWorld) return false;
+        setMatrix(composed);
+        return true;
+    }
+    
+    virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
+        if (!object->hit(localRay(ray), tMin, tMax, record))
+            return false;
+        
+        record.point = toWorld.transformPoint(record.point);
+        record.normal = normalize(normalMatrix.transformVector(record.normal));
+        return true;
+    }
+    
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        return object->occluded(localRay(ray), tMin, tMax);
+    }
+    
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        object->hitPacket(localPacket(packet, mask), mask, tMin, result, index);
+    }
+    
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        return object->occludedPacket(localPacket(packet, mask), mask, tMin, tMax);
+    }
+    
+    virtual AABB boundingBox() const override {
+        return object->boundingBox().transformed(toWorld);
+    }
+    
+    virtual AffineMatrix matrix() const override {
+        return toWorld;
+    }
+    
+private:
+    Ray localRay(const Ray& ray) const {
+        return Ray(toObject.transformPoint(ray.origin), toObject.transformVector(ray.direction));
+    }
+    
+    RayPacket localPacket(const RayPacket& packet, const PacketMask& mask) const {
+        return RayPacket(toObject.transformPoint(packet.origin), toObject.transformVector(packet.direction), mask);
+    }
+};
+
+#endif // AFFINE_TRANSFORM_H
@@ -22,6 +22,12 @@ public:
         buildRotationMatrix();
     }
     
+    // Muda o ângulo (animação); recalcula as matrizes
+    void setAngle(float degrees) {
+        angle = degrees;
+        buildRotationMatrix();
+    }
+    
     // Implementação do método hit para objetos rotacionados
     virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
         // Transformação inversa do raio (aplicar rotação inversa)
@@ -40,6 +46,30 @@ public:
         return true;
     }
     
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        Ray rotatedRay(applyInverseRotation(ray.origin), applyInverseRotation(ray.direction));
+        return object->occluded(rotatedRay, tMin, tMax);
+    }
+    
+    virtual AffineMatrix matrix() const override {
+        return AffineMatrix(rotation[0], rotation[1], rotation[2], Vector3(0, 0, 0));
+    }
+    
+    // Caixa que envolve os 8 cantos da caixa do objeto após a rotação
+    virtual AABB boundingBox() const override {
+        AABB box = object->boundingBox();
+        AABB rotated;
+        for (int i = 0; i < 8; i++) {
+            Vector3 corner(
+                (i & 1) ? box.max.x : box.min.x,
+                (i & 2) ? box.max.y : box.min.y,
+                (i & 4) ? box.max.z : box.min.z
+            );
+            rotated.expand(applyRotation(corner));
+        }
+        return rotated;
+    }
+    
 private:
     // Constrói as matrizes de rotação e rotação inversa
     void buildRotationMatrix() {
@@ -0,0 +1,69 @@
+#ifndef SCALE_H
+#define SCALE_H
+
+#include "Transform.h"
+
+// Escala de objetos por um fator em cada eixo (fatores negativos espelham)
+class Scale : public Transform {
+public:
+    Vector3 factors;    // Fator de escala em x, y e z
+    Vector3 inverse;    // Inverso de cada fator
+    
+    Scale(Primitive* object, float x, float y, float z)
+        : Transform(object), factors(x, y, z), inverse(1.0f / x, 1.0f / y, 1.0f / z) {}
+    
+    Scale(Primitive* object, float factor)
+        : Transform(object), factors(factor, factor, factor), inverse(1.0f / factor, 1.0f / factor, 1.0f / factor) {}
+    
+    // O raio vai ao espaço do objeto sem normalizar a direção, então o
+    // parâmetro t da interseção vale nos dois espaços
+    virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override {
+        if (!object->hit(localRay(ray), tMin, tMax, record))
+            return false;
+        
+        // Normais usam o inverso da escala (inversa transposta)
+        record.point = multiply(record.point, factors);
+        record.normal = normalize(multiply(record.normal, inverse));
+        return true;
+    }
+    
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        return object->occluded(localRay(ray), tMin, tMax);
+    }
+    
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        object->hitPacket(localPacket(packet, mask), mask, tMin, result, index);
+    }
+    
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        return object->occludedPacket(localPacket(packet, mask), mask, tMin, tMax);
+    }
+    
+    virtual AABB boundingBox() const override {
+        return object->boundingBox().transformed(matrix());
+    }
+    
+    virtual AffineMatrix matrix() const override {
+        return AffineMatrix::scale(factors);
+    }
+    
+private:
+    Ray localRay(const Ray& ray) const {
+        return Ray(multiply(ray.origin, inverse), multiply(ray.direction, inverse));
+    }
+    
+    RayPacket localPacket(const RayPacket& packet, const PacketMask& mask) const {
+        PacketFloat sx(inverse.x), sy(inverse.y), sz(inverse.z);
+        return RayPacket(PacketVec3(packet.origin.x * sx, packet.origin.y * sy, packet.origin.z * sz),
+                         PacketVec3(packet.direction.x * sx, packet.direction.y * sy, packet.direction.z * sz), mask);
+    }
+    
+    // Produto componente a componente
+    static Vector3 multiply(const Vector3& a, const Vector3& b) {
+        return Vector3(a.x * b.x, a.y * b.y, a.z * b.z);
+    }
+};
+
+#endif // SCALE_H
@@ -2,6 +2,7 @@
 #define TRANSFORM_H
 
 #include "../geometry/Primitive.h"
+#include "../core/AffineMatrix.h"
 
 // Interface para transformações geométricas
 class Transform : public Primitive {
@@ -13,6 +14,33 @@ public:
     
     // A implementação de hit deve ser fornecida pelas subclasses
     virtual bool hit(const Ray& ray, float tMin, float tMax, HitRecord& record) const override = 0;
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override = 0;
+    virtual AABB boundingBox() const override = 0;
+    
+    // Transformação do espaço do objeto para o espaço de fora, usada para
+    // reduzir cadeias de transformações a uma única matriz (Instance)
+    virtual AffineMatrix matrix() const = 0;
+    
+    // O material é o do objeto transformado
+    virtual Material* getMaterial() const override { return object->getMaterial(); }
+    
+    virtual size_t accelerationMemory() const override { return object->accelerationMemory(); }
+    
+    // Compõe as matrizes de uma cadeia de transformações aninhadas. Ao final,
+    // "object" aponta para o primeiro objeto que não é uma transformação e
+    // "length" (se não for nulo) recebe o número de transformações da cadeia.
+    static AffineMatrix composeChain(Primitive*& object, int* length = nullptr) {
+        AffineMatrix result;
+        int count = 0;
+        const Transform* transform;
+        while ((transform = dynamic_cast<const Transform*>(object)) != nullptr) {
+            result = result * transform->matrix();
+            object = transform->object;
+            count++;
+        }
+        if (length) *length = count;
+        return result;
+    }
 };
 
 #endif // TRANSFORM_H 
\ No newline at end of file
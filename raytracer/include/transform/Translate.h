@@ -28,6 +28,35 @@ public:
         
         return true;
     }
+
+    virtual bool occluded(const Ray& ray, float tMin, float tMax) const override {
+        Ray movedRay(ray.origin - offset, ray.direction);
+        return object->occluded(movedRay, tMin, tMax);
+    }
+
+    virtual void hitPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                           PacketHit& result, int index) const override {
+        RayPacket movedPacket = packet;
+        movedPacket.origin = packet.origin - PacketVec3(offset);
+        object->hitPacket(movedPacket, mask, tMin, result, index);
+    }
+
+    virtual PacketMask occludedPacket(const RayPacket& packet, const PacketMask& mask, float tMin,
+                                      const PacketFloat& tMax) const override {
+        RayPacket movedPacket = packet;
+        movedPacket.origin = packet.origin - PacketVec3(offset);
+        return object->occludedPacket(movedPacket, mask, tMin, tMax);
+    }
+
+    virtual AffineMatrix matrix() const override {
+        return AffineMatrix::translate(offset);
+    }
+
+    // Caixa do objeto deslocada pela translação
+    virtual AABB boundingBox() const override {
+        AABB box = object->boundingBox();
+        return AABB(box.min + offset, box.max + offset);
+    }
 };
 
 #endif // TRANSLATE_H
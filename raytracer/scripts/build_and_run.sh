@@ -9,6 +9,11 @@ if [ ! -d "$BUILD_DIR" ]; then
     mkdir -p "$BUILD_DIR"
 fi
 
+# Flags de arquitetura: por padrão os exemplos são compilados para o processador
+# local, onde são executados em seguida; RAYTRACER_ARCH_FLAGS substitui o padrão
+# (por exemplo RAYTRACER_ARCH_FLAGS="" para um binário portável)
+ARCH_FLAGS="${RAYTRACER_ARCH_FLAGS--march=native}"
+
 # Diretório para imagens de saída
 OUTPUT_DIR="$ROOT_DIR/output"
 if [ ! -d "$OUTPUT_DIR" ]; then
@@ -21,7 +26,7 @@ compile_and_run() {
     local example_file=$2
     
     echo "Compilando o exemplo $example_name..."
-    g++ -std=c++11 -O3 -I"$ROOT_DIR" "$ROOT_DIR/examples/$example_file" -o "$BUILD_DIR/$example_name"
+    g++ -std=c++11 -O3 $ARCH_FLAGS -I"$ROOT_DIR" "$ROOT_DIR/examples/$example_file" -o "$BUILD_DIR/$example_name"
     
     # Verificar se a compilação foi bem-sucedida
     if [ $? -eq 0 ]; then
@@ -32,21 +37,16 @@ compile_and_run() {
         cd "$BUILD_DIR"
         ./$example_name
         
-        # Mover a imagem para o diretório de saída
-        if [ -f "$example_name.ppm" ]; then
-            mv "$example_name.ppm" "$OUTPUT_DIR/"
-            echo "Imagem salva em $OUTPUT_DIR/$example_name.ppm"
-            
-            # Converter para PNG se o ImageMagick estiver instalado
-            if command -v convert >/dev/null 2>&1; then
-                echo "Convertendo PPM para PNG..."
-                convert "$OUTPUT_DIR/$example_name.ppm" "$OUTPUT_DIR/$example_name.png"
-                echo "Imagem convertida para $OUTPUT_DIR/$example_name.png"
-            else
-                echo "ImageMagick não encontrado. A imagem foi salva apenas no formato PPM."
+        # Mover as imagens para o diretório de saída (PNG e PFM são gravados pelo próprio raytracer)
+        if [ -f "$example_name.png" ]; then
+            mv "$example_name.png" "$OUTPUT_DIR/"
+            echo "Imagem salva em $OUTPUT_DIR/$example_name.png"
+            if [ -f "$example_name.pfm" ]; then
+                mv "$example_name.pfm" "$OUTPUT_DIR/"
+                echo "Radiância linear salva em $OUTPUT_DIR/$example_name.pfm"
             fi
         else
-            echo "Erro: A imagem $example_name.ppm não foi gerada!"
+            echo "Erro: A imagem $example_name.png não foi gerada!"
         fi
     else
         echo "Erro na compilação de $example_name!"
@@ -9,6 +9,11 @@ if [ ! -d "$BUILD_DIR" ]; then
     mkdir -p "$BUILD_DIR"
 fi
 
+# Flags de arquitetura: por padrão os exemplos são compilados para o processador
+# local, onde são executados em seguida; RAYTRACER_ARCH_FLAGS substitui o padrão
+# (por exemplo RAYTRACER_ARCH_FLAGS="" para um binário portável)
+ARCH_FLAGS="${RAYTRACER_ARCH_FLAGS--march=native}"
+
 # Diretório para imagens de saída
 OUTPUT_DIR="$ROOT_DIR/output"
 if [ ! -d "$OUTPUT_DIR" ]; then
@@ -19,7 +24,7 @@ fi
 EXAMPLE_NAME="enhanced_scene"
 
 echo "Compilando cena avançada com materiais reflexivos e luz retangular..."
-g++ -std=c++11 -O3 -I"$ROOT_DIR" "$ROOT_DIR/examples/$EXAMPLE_NAME.cpp" -o "$BUILD_DIR/$EXAMPLE_NAME"
+g++ -std=c++11 -O3 $ARCH_FLAGS -I"$ROOT_DIR" "$ROOT_DIR/examples/$EXAMPLE_NAME.cpp" -o "$BUILD_DIR/$EXAMPLE_NAME"
 
 # Verificar se a compilação foi bem-sucedida
 if [ $? -eq 0 ]; then
@@ -30,25 +35,20 @@ if [ $? -eq 0 ]; then
     cd "$BUILD_DIR"
     ./$EXAMPLE_NAME
     
-    # Mover a imagem para o diretório de saída
-    if [ -f "$EXAMPLE_NAME.ppm" ]; then
-        mv "$EXAMPLE_NAME.ppm" "$OUTPUT_DIR/"
-        echo "Imagem salva em $OUTPUT_DIR/$EXAMPLE_NAME.ppm"
+    # Mover as imagens para o diretório de saída (PNG e PFM são gravados pelo próprio raytracer)
+    if [ -f "$EXAMPLE_NAME.png" ]; then
+        mv "$EXAMPLE_NAME.png" "$OUTPUT_DIR/"
+        echo "Imagem salva em $OUTPUT_DIR/$EXAMPLE_NAME.png"
+        if [ -f "$EXAMPLE_NAME.pfm" ]; then
+            mv "$EXAMPLE_NAME.pfm" "$OUTPUT_DIR/"
+            echo "Radiância linear salva em $OUTPUT_DIR/$EXAMPLE_NAME.pfm"
+        fi
         
-        # Converter para PNG se o ImageMagick estiver instalado
-        if command -v convert >/dev/null 2>&1; then
-            echo "Convertendo PPM para PNG..."
-            convert "$OUTPUT_DIR/$EXAMPLE_NAME.ppm" "$OUTPUT_DIR/$EXAMPLE_NAME.png"
-            echo "Imagem convertida para $OUTPUT_DIR/$EXAMPLE_NAME.png"
-            
-            # Abrir a imagem (opcional)
-            if command -v open >/dev/null 2>&1; then  # Para macOS
-                open "$OUTPUT_DIR/$EXAMPLE_NAME.png"
-            elif command -v display >/dev/null 2>&1; then  # Para Linux com ImageMagick
-                display "$OUTPUT_DIR/$EXAMPLE_NAME.png"
-            fi
-        else
-            echo "ImageMagick não encontrado. A imagem foi salva apenas no formato PPM."
+        # Abrir a imagem (opcional)
+        if command -v open >/dev/null 2>&1; then  # Para macOS
+            open "$OUTPUT_DIR/$EXAMPLE_NAME.png"
+        elif command -v xdg-open >/dev/null 2>&1; then  # Para Linux
+            xdg-open "$OUTPUT_DIR/$EXAMPLE_NAME.png"
         fi
     else
         echo "Erro: A imagem não foi gerada!"